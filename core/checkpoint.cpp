@@ -0,0 +1,213 @@
+#include "backends/p4tools/modules/rtsmith/core/checkpoint.h"
+
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/util/delimited_message_util.h>
+#pragma GCC diagnostic pop
+
+#include "backends/p4tools/common/lib/util.h"
+#include "lib/error.h"
+#include "lib/exceptions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+namespace {
+
+constexpr const char *POSITION_FILE = "position.txt";
+constexpr const char *SNAPSHOT_FILE = "snapshot.bin";
+constexpr const char *JOURNAL_FILE = "journal.bin";
+
+/// Append the length-delimited messages in @param path to @param messages. The file may be
+/// gzip-compressed.
+bool readDelimitedMessages(const std::filesystem::path &path,
+                           const google::protobuf::Message &prototype,
+                           std::vector<std::unique_ptr<google::protobuf::Message>> &messages) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input.is_open()) {
+        error("P4RuntimeSmith: Failed to open %1%.", path.c_str());
+        return false;
+    }
+    std::string magic(2, '\0');
+    input.read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    magic.resize(input.gcount());
+    input.clear();
+    input.seekg(0);
+    google::protobuf::io::IstreamInputStream fileStream(&input);
+    std::optional<google::protobuf::io::GzipInputStream> gzipStream;
+    google::protobuf::io::ZeroCopyInputStream *stream = &fileStream;
+    if (isGzip(magic)) {
+        stream = &gzipStream.emplace(&fileStream, google::protobuf::io::GzipInputStream::GZIP);
+    }
+    while (true) {
+        std::unique_ptr<google::protobuf::Message> message(prototype.New());
+        bool cleanEof = false;
+        if (!google::protobuf::util::ParseDelimitedFromZeroCopyStream(message.get(), stream,
+                                                                      &cleanEof)) {
+            if (cleanEof) {
+                return true;
+            }
+            // A truncated message at the end of the journal was not completely written before
+            // the restart. It was never emitted, so it is dropped.
+            warning("P4RuntimeSmith: Ignoring a truncated message at the end of %1%.",
+                    path.c_str());
+            return true;
+        }
+        messages.push_back(std::move(message));
+    }
+}
+
+}  // namespace
+
+Checkpoint::Checkpoint(std::filesystem::path dir, uint32_t seed, uint64_t interval,
+                       Compression compression)
+    : dir(std::move(dir)), seed(seed), interval(interval), compression(compression) {
+    BUG_CHECK(interval > 0, "The checkpoint interval must be positive.");
+}
+
+uint32_t Checkpoint::deriveSeed(uint32_t seed, uint64_t epoch) {
+    // SplitMix64 finalizer, so that consecutive epochs get unrelated seeds.
+    uint64_t value = (static_cast<uint64_t>(seed) << 32) ^ epoch;
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    value ^= value >> 31;
+    return static_cast<uint32_t>(value);
+}
+
+bool Checkpoint::load(const google::protobuf::Message &prototype,
+                      std::vector<std::unique_ptr<google::protobuf::Message>> &requests) {
+    std::ifstream positionFile(dir / POSITION_FILE);
+    if (!positionFile.is_open()) {
+        error("P4RuntimeSmith: %1% does not contain a checkpoint.", dir.c_str());
+        return false;
+    }
+    uint32_t checkpointSeed = 0;
+    positionFile >> checkpointSeed >> position.epoch >> position.steps >> position.requests >>
+        position.totalSteps;
+    if (!positionFile) {
+        error("P4RuntimeSmith: The checkpoint position in %1% is malformed.", dir.c_str());
+        return false;
+    }
+    if (checkpointSeed != seed) {
+        warning("P4RuntimeSmith: The checkpoint was created with seed %1%, continuing with it.",
+                checkpointSeed);
+        seed = checkpointSeed;
+    }
+    if (!readDelimitedMessages(dir / SNAPSHOT_FILE, prototype, requests)) {
+        return false;
+    }
+    if (std::filesystem::exists(dir / JOURNAL_FILE)) {
+        return readDelimitedMessages(dir / JOURNAL_FILE, prototype, requests);
+    }
+    return true;
+}
+
+bool Checkpoint::startEpoch(const google::protobuf::Message &snapshot) {
+    std::error_code errorCode;
+    std::filesystem::create_directories(dir, errorCode);
+    if (errorCode) {
+        error("P4RuntimeSmith: Failed to create checkpoint directory %1%: %2%", dir.c_str(),
+              errorCode.message());
+        return false;
+    }
+    std::string serializedSnapshot;
+    {
+        google::protobuf::io::StringOutputStream stream(&serializedSnapshot);
+        if (!google::protobuf::util::SerializeDelimitedToZeroCopyStream(snapshot, &stream)) {
+            error("P4RuntimeSmith: Failed to serialize the checkpoint snapshot.");
+            return false;
+        }
+    }
+    if (compression == Compression::Gzip) {
+        serializedSnapshot = compressGzip(serializedSnapshot);
+    }
+    if (!writeFile(dir / SNAPSHOT_FILE, serializedSnapshot)) {
+        return false;
+    }
+    position.epoch++;
+    stepsInEpoch = 0;
+    // The journal only holds the requests after the snapshot.
+    pendingJournal.clear();
+    journal.close();
+    journal.open(dir / JOURNAL_FILE, std::ios::binary | std::ios::trunc);
+    if (!journal.is_open()) {
+        error("P4RuntimeSmith: Failed to open the checkpoint journal in %1%.", dir.c_str());
+        return false;
+    }
+    Utils::setRandomSeed(static_cast<int>(deriveSeed(seed, position.epoch)));
+    return writePosition();
+}
+
+bool Checkpoint::appendToJournal(const google::protobuf::Message &request) {
+    if (compression == Compression::Gzip) {
+        google::protobuf::io::StringOutputStream stream(&pendingJournal);
+        if (!google::protobuf::util::SerializeDelimitedToZeroCopyStream(request, &stream)) {
+            error("P4RuntimeSmith: Failed to serialize a request for the checkpoint journal.");
+            return false;
+        }
+        return true;
+    }
+    if (!google::protobuf::util::SerializeDelimitedToOstream(request, &journal)) {
+        error("P4RuntimeSmith: Failed to append to the checkpoint journal in %1%.", dir.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::completeStep(uint64_t numRequests) {
+    position.steps++;
+    position.requests += numRequests;
+    stepsInEpoch++;
+    // A compressed journal gets one gzip member per time step, so that every completed step can be
+    // decompressed on its own.
+    if (!pendingJournal.empty()) {
+        journal << compressGzip(pendingJournal);
+        pendingJournal.clear();
+    }
+    // The journal must be durable before the position refers to it.
+    journal.flush();
+    writePosition();
+    return stepsInEpoch >= interval;
+}
+
+bool Checkpoint::setTotalSteps(uint64_t totalSteps) {
+    position.totalSteps = totalSteps;
+    return writePosition();
+}
+
+bool Checkpoint::writeFile(const std::filesystem::path &path, const std::string &contents) {
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+        output << contents;
+        if (!output.good()) {
+            error("P4RuntimeSmith: Failed to write %1%.", temporaryPath.c_str());
+            return false;
+        }
+    }
+    std::error_code errorCode;
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    if (errorCode) {
+        error("P4RuntimeSmith: Failed to replace %1%: %2%", path.c_str(), errorCode.message());
+        return false;
+    }
+    return true;
+}
+
+bool Checkpoint::writePosition() const {
+    std::stringstream contents;
+    contents << seed << " " << position.epoch << " " << position.steps << " "
+             << position.requests << " " << position.totalSteps << "\n";
+    return writeFile(dir / POSITION_FILE, contents.str());
+}
+
+}  // namespace P4::P4Tools::RtSmith
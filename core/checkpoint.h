@@ -0,0 +1,126 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_CHECKPOINT_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_CHECKPOINT_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/message.h>
+#pragma GCC diagnostic pop
+
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+
+namespace P4::P4Tools::RtSmith {
+
+/// Persists the progress of an update series so that it can be continued after a restart.
+/// A checkpoint directory contains three files:
+///  - `position.txt`: The seed, the current epoch, the number of completed time steps and
+///    emitted requests, and the length of the update series.
+///  - `snapshot.bin`: The installed state at the start of the epoch as a single write request of
+///    insertions.
+///  - `journal.bin`: The write requests emitted since the start of the epoch.
+/// Messages are stored length-delimited and optionally gzip-compressed. Each epoch starts with a
+/// new snapshot and an empty journal, so the cost of a time step is independent of the size of the
+/// installed state. The random number generator is reseeded at the start of every epoch with a seed
+/// derived from the seed and the epoch, which makes its state reproducible without serializing it.
+class Checkpoint {
+ public:
+    /// The progress of the update series.
+    struct Position {
+        /// The number of snapshots taken so far.
+        uint64_t epoch = 0;
+
+        /// The number of completed time steps of the update series.
+        uint64_t steps = 0;
+
+        /// The number of requests emitted by the completed time steps.
+        uint64_t requests = 0;
+
+        /// The total number of time steps of the update series, 0 if not known yet.
+        uint64_t totalSteps = 0;
+    };
+
+    /// @param dir The checkpoint directory. Created if it does not exist.
+    /// @param seed The seed of the run.
+    /// @param interval The number of time steps between snapshots. Must be positive.
+    /// @param compression The compression of the snapshot and the journal. Loading detects it.
+    Checkpoint(std::filesystem::path dir, uint32_t seed, uint64_t interval,
+               Compression compression = Compression::None);
+
+    /// @returns the seed of the random number generator for @param epoch of a run with
+    /// @param seed.
+    static uint32_t deriveSeed(uint32_t seed, uint64_t epoch);
+
+    /// @brief Load an existing checkpoint.
+    /// @param prototype An empty write request of the control plane API of the checkpoint.
+    /// @param requests Filled with the snapshot request followed by the requests of the journal.
+    /// Applying them in order restores the installed state.
+    /// @return False if the checkpoint can not be read.
+    bool load(const google::protobuf::Message &prototype,
+              std::vector<std::unique_ptr<google::protobuf::Message>> &requests);
+
+    /// @brief Start a new epoch: Write `snapshot` of the installed state, clear the journal, and
+    /// reseed the random number generator.
+    /// @param snapshot A write request that installs the current state.
+    /// @return False if the checkpoint can not be written.
+    bool startEpoch(const google::protobuf::Message &snapshot);
+
+    /// @brief Append `request` to the journal.
+    /// @return False if the journal can not be written.
+    bool appendToJournal(const google::protobuf::Message &request);
+
+    /// @brief Record the completion of a time step.
+    /// @param numRequests The number of requests the time step emitted.
+    /// @return True if a new epoch should be started.
+    bool completeStep(uint64_t numRequests);
+
+    /// @brief Record the total number of time steps of the update series, so that a resumed run
+    /// produces a series of the same length.
+    /// @return False if the checkpoint can not be written.
+    bool setTotalSteps(uint64_t totalSteps);
+
+    /// @returns the progress of the update series.
+    [[nodiscard]] const Position &getPosition() const { return position; }
+
+ private:
+    /// The checkpoint directory.
+    std::filesystem::path dir;
+
+    /// The seed of the run.
+    uint32_t seed;
+
+    /// The number of time steps between snapshots.
+    uint64_t interval;
+
+    /// The progress of the update series.
+    Position position;
+
+    /// The number of time steps completed in the current epoch.
+    uint64_t stepsInEpoch = 0;
+
+    /// The compression of the snapshot and the journal.
+    Compression compression;
+
+    /// The journal of the current epoch, open for appending.
+    std::ofstream journal;
+
+    /// The compressed journal is written once per time step. The requests of the current time step
+    /// are collected here until then.
+    std::string pendingJournal;
+
+    /// Atomically replace @param path with @param contents.
+    static bool writeFile(const std::filesystem::path &path, const std::string &contents);
+
+    /// Write the position file.
+    bool writePosition() const;
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_CHECKPOINT_H_ */
@@ -0,0 +1,130 @@
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/gzip_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#pragma GCC diagnostic pop
+
+#include "lib/error.h"
+#include "lib/exceptions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+namespace {
+
+/// Copy @param data into @param output. @returns false if the stream fails.
+bool writeToStream(std::string_view data, google::protobuf::io::ZeroCopyOutputStream &output) {
+    while (!data.empty()) {
+        void *buffer = nullptr;
+        int size = 0;
+        if (!output.Next(&buffer, &size)) {
+            return false;
+        }
+        auto numBytes = std::min(data.size(), static_cast<size_t>(size));
+        std::memcpy(buffer, data.data(), numBytes);
+        output.BackUp(size - static_cast<int>(numBytes));
+        data.remove_prefix(numBytes);
+    }
+    return true;
+}
+
+}  // namespace
+
+std::filesystem::path getCompressedPath(const std::filesystem::path &path,
+                                        Compression compression) {
+    switch (compression) {
+        case Compression::None:
+            return path;
+        case Compression::Gzip: {
+            auto compressedPath = path;
+            return compressedPath += ".gz";
+        }
+    }
+    BUG("Unknown compression");
+}
+
+bool isGzip(std::string_view data) {
+    return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f &&
+           static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+std::string compressGzip(std::string_view data) {
+    std::string compressed;
+    {
+        google::protobuf::io::StringOutputStream output(&compressed);
+        google::protobuf::io::GzipOutputStream gzipOutput(&output);
+        BUG_CHECK(writeToStream(data, gzipOutput) && gzipOutput.Close(), "Failed to compress %1%",
+                  gzipOutput.ZlibErrorMessage());
+    }
+    return compressed;
+}
+
+std::optional<std::string> decompressGzip(std::string_view data) {
+    if (data.size() > static_cast<size_t>(INT_MAX)) {
+        return std::nullopt;
+    }
+    google::protobuf::io::ArrayInputStream input(data.data(), static_cast<int>(data.size()));
+    google::protobuf::io::GzipInputStream gzipInput(&input,
+                                                    google::protobuf::io::GzipInputStream::GZIP);
+    std::string decompressed;
+    const void *buffer = nullptr;
+    int size = 0;
+    while (gzipInput.Next(&buffer, &size)) {
+        decompressed.append(static_cast<const char *>(buffer), size);
+    }
+    // The stream also stops at the end of the input. Truncated data yields the decompressed
+    // prefix, which fails to parse like a truncated uncompressed file.
+    if (gzipInput.ZlibErrorMessage() != nullptr) {
+        return std::nullopt;
+    }
+    return decompressed;
+}
+
+CompressedOutputFile::CompressedOutputFile() = default;
+
+CompressedOutputFile::~CompressedOutputFile() { close(); }
+
+bool CompressedOutputFile::open(const std::filesystem::path &path, Compression compression) {
+    close();
+    file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    if (compression == Compression::Gzip) {
+        fileStream = std::make_unique<google::protobuf::io::OstreamOutputStream>(&file);
+        gzipStream = std::make_unique<google::protobuf::io::GzipOutputStream>(fileStream.get());
+    }
+    return true;
+}
+
+bool CompressedOutputFile::write(std::string_view data) {
+    if (gzipStream != nullptr) {
+        return writeToStream(data, *gzipStream);
+    }
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+bool CompressedOutputFile::close() {
+    if (!file.is_open()) {
+        return true;
+    }
+    auto success = true;
+    if (gzipStream != nullptr) {
+        success = gzipStream->Close();
+        gzipStream.reset();
+        // Destroying the adapter flushes its buffer into the file.
+        fileStream.reset();
+    }
+    file.close();
+    return success && !file.fail();
+}
+
+}  // namespace P4::P4Tools::RtSmith
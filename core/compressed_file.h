@@ -0,0 +1,67 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_COMPRESSED_FILE_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_COMPRESSED_FILE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace google::protobuf::io {
+class GzipOutputStream;
+class OstreamOutputStream;
+}  // namespace google::protobuf::io
+
+namespace P4::P4Tools::RtSmith {
+
+/// The compression of the files RtSmith writes.
+enum class Compression { None, Gzip };
+
+/// @returns @param path with the file extension of @param compression appended, e.g.,
+/// "initial_config.txtpb.gz" for gzip.
+[[nodiscard]] std::filesystem::path getCompressedPath(const std::filesystem::path &path,
+                                                      Compression compression);
+
+/// @returns true if @param data starts with the gzip magic number.
+[[nodiscard]] bool isGzip(std::string_view data);
+
+/// @returns @param data compressed as a single gzip member. Gzip members can be concatenated, so
+/// the result can be appended to an existing gzip file.
+[[nodiscard]] std::string compressGzip(std::string_view data);
+
+/// @returns the decompressed content of the gzip data @param data, which may consist of several
+/// members, or std::nullopt if it is not valid gzip data.
+[[nodiscard]] std::optional<std::string> decompressGzip(std::string_view data);
+
+/// A file that is compressed while it is written. Without compression, the data is written as is.
+class CompressedOutputFile {
+    /// The underlying file.
+    std::ofstream file;
+
+    /// The stream adapters used for compression, only set while a compressed file is open.
+    std::unique_ptr<google::protobuf::io::OstreamOutputStream> fileStream;
+    std::unique_ptr<google::protobuf::io::GzipOutputStream> gzipStream;
+
+ public:
+    CompressedOutputFile();
+    CompressedOutputFile(const CompressedOutputFile &) = delete;
+    CompressedOutputFile &operator=(const CompressedOutputFile &) = delete;
+    CompressedOutputFile(CompressedOutputFile &&) = delete;
+    CompressedOutputFile &operator=(CompressedOutputFile &&) = delete;
+    ~CompressedOutputFile();
+
+    /// Open the file at @param path, replacing its content. @returns false if it can not be opened.
+    bool open(const std::filesystem::path &path, Compression compression);
+
+    /// Append @param data to the file. @returns false if it can not be written.
+    bool write(std::string_view data);
+
+    /// Finish the compression and close the file. @returns false if it can not be written.
+    bool close();
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_COMPRESSED_FILE_H_ */
@@ -1,5 +1,7 @@
 #include "backends/p4tools/modules/rtsmith/core/config.h"
 
+#include <algorithm>
+
 #include "lib/error.h"
 
 namespace P4::P4Tools::RtSmith {
@@ -29,12 +31,37 @@ void FuzzerConfig::setMaxTables(const int numTables) {
 
 void FuzzerConfig::setThresholdForDeletion(const uint64_t threshold) {
     thresholdForDeletion = threshold;
+    // Split the operations on installed entries between modifications and deletions.
+    auto existingEntryWeight = modifyWeight + deleteWeight;
+    deleteWeight = existingEntryWeight * std::min<uint64_t>(threshold, 100) / 100;
+    modifyWeight = existingEntryWeight - deleteWeight;
 }
 
+void FuzzerConfig::setInsertWeight(const uint64_t weight) { insertWeight = weight; }
+
+void FuzzerConfig::setModifyWeight(const uint64_t weight) { modifyWeight = weight; }
+
+void FuzzerConfig::setDeleteWeight(const uint64_t weight) { deleteWeight = weight; }
+
 void FuzzerConfig::setTablesToSkip(const std::vector<std::string> &tables) {
     tablesToSkip = tables;
 }
 
+void FuzzerConfig::setTableWeighting(const std::string &kind) {
+    if (kind == "uniform") {
+        tableWeighting = TableWeighting::Uniform;
+    } else if (kind == "size") {
+        tableWeighting = TableWeighting::Size;
+    } else if (kind == "keyWidth") {
+        tableWeighting = TableWeighting::KeyWidth;
+    } else {
+        error(
+            "ControlPlaneSmith: Unknown table weighting %1%. Expected one of uniform, size, and "
+            "keyWidth.",
+            kind);
+    }
+}
+
 void FuzzerConfig::setMaxUpdateCount(const size_t count) { maxUpdateCount = count; }
 
 void FuzzerConfig::setMaxUpdateTimeInMicroseconds(const uint64_t micros) {
@@ -50,4 +77,140 @@ void FuzzerConfig::setMinUpdateTimeInMicroseconds(const uint64_t micros) {
     minUpdateTimeInMicroseconds = micros;
 }
 
+void FuzzerConfig::setMaxUpdatesPerRequest(const size_t count) { maxUpdatesPerRequest = count; }
+
+void FuzzerConfig::setMaxBytesPerRequest(const size_t bytes) { maxBytesPerRequest = bytes; }
+
+void FuzzerConfig::setMaxActionProfileMembers(const int numMembers) {
+    if (numMembers < 0) {
+        error(
+            "ControlPlaneSmith: The maximum number of action profile members must be a "
+            "non-negative integer.");
+    }
+    maxActionProfileMembers = numMembers;
+}
+
+void FuzzerConfig::setMaxSelectorGroups(const int numGroups) {
+    if (numGroups < 0) {
+        error(
+            "ControlPlaneSmith: The maximum number of selector groups must be a non-negative "
+            "integer.");
+    }
+    maxSelectorGroups = numGroups;
+}
+
+void FuzzerConfig::setMinGroupSize(const int size) {
+    if (size <= 0) {
+        error("ControlPlaneSmith: The minimum group size must be a positive integer.");
+    }
+    minGroupSize = size;
+}
+
+void FuzzerConfig::setMaxGroupSize(const int size) {
+    if (size <= 0) {
+        error("ControlPlaneSmith: The maximum group size must be a positive integer.");
+    }
+    maxGroupSize = size;
+}
+
+void FuzzerConfig::setMaxMemberWeight(const int weight) {
+    if (weight <= 0) {
+        error("ControlPlaneSmith: The maximum member weight must be a positive integer.");
+    }
+    maxMemberWeight = weight;
+}
+
+void FuzzerConfig::setMaxMulticastGroups(const int numGroups) {
+    if (numGroups < 0) {
+        error(
+            "ControlPlaneSmith: The maximum number of multicast groups must be a non-negative "
+            "integer.");
+    }
+    maxMulticastGroups = numGroups;
+}
+
+void FuzzerConfig::setMaxCloneSessions(const int numSessions) {
+    if (numSessions < 0) {
+        error(
+            "ControlPlaneSmith: The maximum number of clone sessions must be a non-negative "
+            "integer.");
+    }
+    maxCloneSessions = numSessions;
+}
+
+void FuzzerConfig::setMinReplicas(const int numReplicas) {
+    if (numReplicas < 0) {
+        error("ControlPlaneSmith: The minimum number of replicas must be a non-negative integer.");
+    }
+    minReplicas = numReplicas;
+}
+
+void FuzzerConfig::setMaxReplicas(const int numReplicas) {
+    if (numReplicas < 0) {
+        error("ControlPlaneSmith: The maximum number of replicas must be a non-negative integer.");
+    }
+    maxReplicas = numReplicas;
+}
+
+void FuzzerConfig::setReadRatio(const double ratio) {
+    if (ratio < 0) {
+        error("ControlPlaneSmith: The read ratio must be non-negative.");
+    }
+    readRatio = ratio;
+}
+
+void FuzzerConfig::setKeyPopularity(const std::string &kind, const double zipfExponent,
+                                    const double hotKeyFraction, const double hotKeyProbability) {
+    if (kind == "uniform") {
+        keyPopularity = KeyPopularity::uniform();
+    } else if (kind == "zipf") {
+        if (zipfExponent <= 0) {
+            error("ControlPlaneSmith: The Zipf exponent must be positive.");
+            return;
+        }
+        keyPopularity = KeyPopularity::zipf(zipfExponent);
+    } else if (kind == "hotcold") {
+        if (hotKeyFraction < 0 || hotKeyFraction > 1 || hotKeyProbability < 0 ||
+            hotKeyProbability > 1) {
+            error(
+                "ControlPlaneSmith: The hot key fraction and the hot key probability must be in "
+                "[0, 1].");
+            return;
+        }
+        keyPopularity = KeyPopularity::hotCold(hotKeyFraction, hotKeyProbability);
+    } else {
+        error(
+            "ControlPlaneSmith: Unknown key popularity %1%. Expected one of uniform, zipf, and "
+            "hotcold.",
+            kind);
+    }
+}
+
+void FuzzerConfig::setReinsertProbability(const double probability) {
+    if (probability < 0 || probability > 1) {
+        error("ControlPlaneSmith: The reinsert probability must be in [0, 1].");
+    }
+    reinsertProbability = probability;
+}
+
+void FuzzerConfig::setWorkloadPhases(const std::vector<WorkloadPhase> &phases) {
+    workloadPhases = phases;
+}
+
+void FuzzerConfig::setOverlapTargets(const std::map<std::string, double> &targets) {
+    for (const auto &[tableName, target] : targets) {
+        if (target < 0) {
+            error("ControlPlaneSmith: The overlap target for table %1% must be non-negative.",
+                  tableName);
+        }
+    }
+    for (const auto &[tableName, target] : targets) {
+        tablePolicies[tableName].overlapTarget = target;
+    }
+}
+
+void FuzzerConfig::setTablePolicy(const std::string &tableName, const TablePolicy &policy) {
+    tablePolicies[tableName] = policy;
+}
+
 }  // namespace P4::P4Tools::RtSmith
@@ -2,13 +2,50 @@
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_CONFIG_H_
 
 #include <filesystem>
+#include <map>
+#include <optional>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/rtsmith/core/distributions.h"
+#include "backends/p4tools/modules/rtsmith/core/write_request_batcher.h"
 
 namespace P4::P4Tools::RtSmith {
 
+/// The generation policy of a single table, configured in a `[tables."<name>"]` section of the
+/// fuzzer configuration. Fields that are not set fall back to the global configuration.
+struct TablePolicy {
+    /// Whether entries are generated for the table.
+    bool enabled = true;
+    /// The number of entries the initial configuration installs in the table.
+    std::optional<uint64_t> entryCount;
+    /// The fraction of the declared size of the table that insertions fill at most.
+    double fillRatio = 1.0;
+    /// The relative weights of inserting, modifying, and deleting entries of the table.
+    std::optional<uint64_t> insertWeight;
+    std::optional<uint64_t> modifyWeight;
+    std::optional<uint64_t> deleteWeight;
+    /// The prefix length of LPM fields is chosen uniformly from [minPrefixLength,
+    /// maxPrefixLength], limited by the width of the field.
+    int minPrefixLength = 0;
+    std::optional<int> maxPrefixLength;
+    /// The probability that a ternary field of a new entry is a wildcard.
+    double wildcardProbability = 0.0;
+    /// The relative weight of the table when tables are selected. Overrides the weight derived
+    /// from the table weighting.
+    std::optional<double> weight;
+    /// The desired average overlap degree of the ternary and range entries of the table. The
+    /// overlap degree of an entry is the number of other entries in the same table it overlaps
+    /// with.
+    std::optional<double> overlapTarget;
+};
+
+/// Decides the weight of a table when tables are selected: Every table has the same weight, or
+/// the weight is the declared size of the table or the total width of its key fields.
+enum class TableWeighting { Uniform, Size, KeyWidth };
+
 class FuzzerConfig {
  private:
     /// The maximum number of entries we are trying to generate for a table.
@@ -17,16 +54,67 @@ class FuzzerConfig {
     int maxAttempts = 100;
     /// The maximum number of tables.
     int maxTables = 5;
-    /// The string representations of tables to skip.
+    /// The names of tables to skip. Names may be glob patterns.
     std::vector<std::string> tablesToSkip;
+    /// Decides the weight of the tables that are not skipped when at most `maxTables` of them are
+    /// selected.
+    TableWeighting tableWeighting = TableWeighting::Uniform;
     /// Threshold for deletion.
     uint64_t thresholdForDeletion = 30;
+    /// The relative weights of inserting a new entry, modifying the action of an installed entry,
+    /// and deleting an installed entry in an update. The split between modifications and deletions
+    /// follows the threshold for deletion unless it is configured explicitly.
+    uint64_t insertWeight = 50;
+    uint64_t modifyWeight = 35;
+    uint64_t deleteWeight = 15;
     /// The maximum number of updates.
     size_t maxUpdateCount = 10;
     /// The maximum time (in microseconds) for the update.
     uint64_t maxUpdateTimeInMicroseconds = 100000;
     /// The minimum time (in microseconds) for the update.
     uint64_t minUpdateTimeInMicroseconds = 50000;
+    /// The maximum number of updates in a single write request. 0 means unlimited.
+    size_t maxUpdatesPerRequest = 0;
+    /// The maximum encoded size (in bytes) of a single write request. 0 means unlimited. Defaults
+    /// to 64 KiB below the 4 MiB default receive limit of gRPC, which leaves room for the fields
+    /// the PTF harness merges into every request.
+    size_t maxBytesPerRequest = DEFAULT_MAX_BYTES_PER_REQUEST;
+    /// The maximum number of members generated for an action profile. 0 disables members, and with
+    /// them the entries of tables that refer to them.
+    int maxActionProfileMembers = 0;
+    /// The maximum number of groups generated for an action selector. 0 disables groups.
+    int maxSelectorGroups = 0;
+    /// The number of members of a selector group is chosen uniformly from [minGroupSize,
+    /// maxGroupSize]. The maximum is further limited by the maximum group size the program
+    /// declares for the selector.
+    int minGroupSize = 1;
+    int maxGroupSize = 4;
+    /// The weight of a group member is chosen uniformly from [1, maxMemberWeight].
+    int maxMemberWeight = 1;
+    /// The maximum number of multicast groups and clone sessions of the packet replication engine.
+    /// 0 disables the respective kind.
+    int maxMulticastGroups = 0;
+    int maxCloneSessions = 0;
+    /// The number of replicas of a multicast group or clone session is chosen uniformly from
+    /// [minReplicas, maxReplicas].
+    int minReplicas = 1;
+    int maxReplicas = 4;
+    /// The expected number of read requests per time step of the update series. Reads are sent
+    /// after the writes of a time step. 0 disables reads.
+    double readRatio = 0.0;
+    /// Decides which installed entry of a table a modification or deletion hits, and which
+    /// deleted entry a re-insertion installs again.
+    KeyPopularity keyPopularity = KeyPopularity::uniform();
+    /// The probability that an insertion installs a previously deleted entry again instead of a
+    /// new one.
+    double reinsertProbability = 0.0;
+    /// The phases of the update series, in order. If empty, the update series consists of a
+    /// single phase with a random number of time steps, bounded by `maxUpdateCount`, delays drawn
+    /// uniformly from [minUpdateTimeInMicroseconds, maxUpdateTimeInMicroseconds], and
+    /// `maxEntryGenCnt` updates per table and time step.
+    std::vector<WorkloadPhase> workloadPhases;
+    /// The generation policies of individual tables, keyed by the table name.
+    std::map<std::string, TablePolicy> tablePolicies;
 
  public:
     // Default constructor.
@@ -40,7 +128,11 @@ class FuzzerConfig {
     [[nodiscard]] int getMaxAttempts() const { return maxAttempts; }
     [[nodiscard]] int getMaxTables() const { return maxTables; }
     [[nodiscard]] const std::vector<std::string> &getTablesToSkip() const { return tablesToSkip; }
+    [[nodiscard]] TableWeighting getTableWeighting() const { return tableWeighting; }
     [[nodiscard]] uint64_t getThresholdForDeletion() const { return thresholdForDeletion; }
+    [[nodiscard]] uint64_t getInsertWeight() const { return insertWeight; }
+    [[nodiscard]] uint64_t getModifyWeight() const { return modifyWeight; }
+    [[nodiscard]] uint64_t getDeleteWeight() const { return deleteWeight; }
     [[nodiscard]] size_t getMaxUpdateCount() const { return maxUpdateCount; }
     [[nodiscard]] uint64_t getMaxUpdateTimeInMicroseconds() const {
         return maxUpdateTimeInMicroseconds;
@@ -48,16 +140,65 @@ class FuzzerConfig {
     [[nodiscard]] uint64_t getMinUpdateTimeInMicroseconds() const {
         return minUpdateTimeInMicroseconds;
     }
+    [[nodiscard]] size_t getMaxUpdatesPerRequest() const { return maxUpdatesPerRequest; }
+    [[nodiscard]] size_t getMaxBytesPerRequest() const { return maxBytesPerRequest; }
+    [[nodiscard]] int getMaxActionProfileMembers() const { return maxActionProfileMembers; }
+    [[nodiscard]] int getMaxSelectorGroups() const { return maxSelectorGroups; }
+    [[nodiscard]] int getMinGroupSize() const { return minGroupSize; }
+    [[nodiscard]] int getMaxGroupSize() const { return maxGroupSize; }
+    [[nodiscard]] int getMaxMemberWeight() const { return maxMemberWeight; }
+    [[nodiscard]] int getMaxMulticastGroups() const { return maxMulticastGroups; }
+    [[nodiscard]] int getMaxCloneSessions() const { return maxCloneSessions; }
+    [[nodiscard]] int getMinReplicas() const { return minReplicas; }
+    [[nodiscard]] int getMaxReplicas() const { return maxReplicas; }
+    [[nodiscard]] double getReadRatio() const { return readRatio; }
+    [[nodiscard]] const KeyPopularity &getKeyPopularity() const { return keyPopularity; }
+    [[nodiscard]] double getReinsertProbability() const { return reinsertProbability; }
+    [[nodiscard]] const std::vector<WorkloadPhase> &getWorkloadPhases() const {
+        return workloadPhases;
+    }
+    [[nodiscard]] const std::map<std::string, TablePolicy> &getTablePolicies() const {
+        return tablePolicies;
+    }
 
     /// Setters to modify/override the fuzzer configurations.
     void setMaxEntryGenCnt(const int numEntries);
     void setMaxAttempts(const int numAttempts);
     void setMaxTables(const int numTables);
     void setTablesToSkip(const std::vector<std::string> &tables);
+    /// @param kind One of "uniform", "size", and "keyWidth".
+    void setTableWeighting(const std::string &kind);
     void setThresholdForDeletion(const uint64_t threshold);
+    void setInsertWeight(const uint64_t weight);
+    void setModifyWeight(const uint64_t weight);
+    void setDeleteWeight(const uint64_t weight);
     void setMaxUpdateCount(const size_t count);
     void setMaxUpdateTimeInMicroseconds(const uint64_t micros);
     void setMinUpdateTimeInMicroseconds(const uint64_t micros);
+    void setMaxUpdatesPerRequest(const size_t count);
+    void setMaxBytesPerRequest(const size_t bytes);
+    void setMaxActionProfileMembers(const int numMembers);
+    void setMaxSelectorGroups(const int numGroups);
+    void setMinGroupSize(const int size);
+    void setMaxGroupSize(const int size);
+    void setMaxMemberWeight(const int weight);
+    void setMaxMulticastGroups(const int numGroups);
+    void setMaxCloneSessions(const int numSessions);
+    void setMinReplicas(const int numReplicas);
+    void setMaxReplicas(const int numReplicas);
+    void setReadRatio(const double ratio);
+    /// @param kind One of "uniform", "zipf", and "hotcold".
+    /// @param zipfExponent The exponent of the Zipf model. Must be positive.
+    /// @param hotKeyFraction The fraction of the entries in the hot set of the hot/cold model.
+    /// @param hotKeyProbability The fraction of the updates the hot set of the hot/cold model
+    /// receives.
+    void setKeyPopularity(const std::string &kind, const double zipfExponent,
+                          const double hotKeyFraction, const double hotKeyProbability);
+    void setReinsertProbability(const double probability);
+    void setWorkloadPhases(const std::vector<WorkloadPhase> &phases);
+    /// Sets the overlap target of the policies of the tables in @param targets.
+    void setOverlapTargets(const std::map<std::string, double> &targets);
+    void setTablePolicy(const std::string &tableName, const TablePolicy &policy);
 };
 
 }  // namespace P4::P4Tools::RtSmith
@@ -0,0 +1,267 @@
+#include "backends/p4tools/modules/rtsmith/core/control_plane/protobuf_utils.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/text_format.h>
+#pragma GCC diagnostic pop
+
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+
+namespace P4::P4Tools::RtSmith::Protobuf {
+
+namespace {
+
+/// A read-only memory mapping of a file. The mapping is released on destruction.
+class MappedFile {
+    /// The start of the mapping, nullptr for empty files.
+    void *data = nullptr;
+
+    /// The size of the file in bytes.
+    size_t size = 0;
+
+ public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    ~MappedFile() {
+        if (data != nullptr) {
+            munmap(data, size);
+        }
+    }
+
+    /// Map the file at @param path. @returns false if the file can not be mapped.
+    bool map(const std::filesystem::path &path) {
+        int fd = open(path.c_str(), O_RDONLY);  // NOLINT, we are forced to use open here.
+        if (fd < 0) {
+            error("Failed to open file %1%", path.c_str());
+            return false;
+        }
+        struct stat fileStat {};
+        if (fstat(fd, &fileStat) != 0) {
+            error("Failed to read the size of file %1%", path.c_str());
+            close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+        if (size > 0) {
+            data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                data = nullptr;
+                error("Failed to map file %1%", path.c_str());
+                close(fd);
+                return false;
+            }
+            // The file is read once from front to back.
+            madvise(data, size, MADV_SEQUENTIAL);
+        }
+        // The mapping stays valid after the descriptor is closed.
+        close(fd);
+        return true;
+    }
+
+    [[nodiscard]] const char *begin() const { return static_cast<const char *>(data); }
+
+    [[nodiscard]] const char *end() const { return begin() + size; }
+
+    [[nodiscard]] size_t getSize() const { return size; }
+};
+
+/// @returns true if the bytes from @param begin to @param end are printable characters or
+/// whitespace. The text format escapes all other characters, so binary encodings almost always
+/// contain one of them.
+bool isText(const char *begin, const char *end) {
+    return std::all_of(begin, end, [](char character) {
+        auto byte = static_cast<unsigned char>(character);
+        return byte >= 0x20 || byte == '\t' || byte == '\n' || byte == '\r';
+    });
+}
+
+/// Parse @param size bytes at @param data as length-delimited messages and merge them into
+/// @param message. @returns false unless the length prefixes frame the data exactly and all
+/// messages parse without unknown fields. A single binary message often happens to be framed
+/// exactly as well, but its parts then end up in unknown fields.
+bool parseLengthDelimited(const char *data, int size, google::protobuf::Message &message) {
+    google::protobuf::io::CodedInputStream input(reinterpret_cast<const uint8_t *>(data), size);
+    std::unique_ptr<google::protobuf::Message> part(message.New());
+    while (input.CurrentPosition() < size) {
+        uint32_t length = 0;
+        if (!input.ReadVarint32(&length) || length > static_cast<uint32_t>(size)) {
+            return false;
+        }
+        auto limit = input.PushLimit(static_cast<int>(length));
+        part->Clear();
+        if (!part->ParseFromCodedStream(&input) || !input.ConsumedEntireMessage() ||
+            input.BytesUntilLimit() != 0 ||
+            !part->GetReflection()->GetUnknownFields(*part).empty()) {
+            return false;
+        }
+        input.PopLimit(limit);
+        message.MergeFrom(*part);
+    }
+    return true;
+}
+
+/// Parse @param size bytes at @param data as length-delimited messages or, if that fails, as a
+/// single binary message. @returns the format or std::nullopt if neither parses without unknown
+/// fields. Malformed text and messages of another type often parse as binary, but their fields
+/// then end up unknown.
+std::optional<MessageFormat> parseBinary(const char *data, int size,
+                                         google::protobuf::Message &message) {
+    message.Clear();
+    if (parseLengthDelimited(data, size, message)) {
+        return MessageFormat::LengthDelimited;
+    }
+    message.Clear();
+    if (message.ParseFromArray(data, size) &&
+        message.GetReflection()->GetUnknownFields(message).empty()) {
+        return MessageFormat::Binary;
+    }
+    message.Clear();
+    return std::nullopt;
+}
+
+/// @returns the name of the first field in the text format message from @param begin to @param
+/// end, skipping whitespace and comments. Empty if the message has no fields.
+std::string_view getFirstTextField(const char *begin, const char *end) {
+    const auto *position = begin;
+    while (position != end) {
+        if (*position == '#') {
+            position = std::find(position, end, '\n');
+        } else if (std::isspace(static_cast<unsigned char>(*position)) != 0) {
+            ++position;
+        } else {
+            break;
+        }
+    }
+    const auto *nameEnd = std::find_if(position, end, [](char character) {
+        return std::isalnum(static_cast<unsigned char>(character)) == 0 && character != '_';
+    });
+    return {position, static_cast<size_t>(nameEnd - position)};
+}
+
+/// Map @param inputFile into @param file. Gzip-compressed files are decompressed into
+/// @param decompressed. @returns the content of the file or std::nullopt if the file can not be
+/// read or is too large for the array streams of Protobuf.
+std::optional<std::string_view> loadFile(const std::filesystem::path &inputFile, MappedFile &file,
+                                         std::string &decompressed) {
+    if (!file.map(inputFile)) {
+        return std::nullopt;
+    }
+    std::string_view content(file.begin(), file.getSize());
+    if (isGzip(content)) {
+        auto result = decompressGzip(content);
+        if (!result.has_value()) {
+            error("Failed to decompress file %1%", inputFile.c_str());
+            return std::nullopt;
+        }
+        decompressed = std::move(result.value());
+        content = decompressed;
+    }
+    if (content.size() > static_cast<size_t>(INT_MAX)) {
+        error("File %1% is too large to parse", inputFile.c_str());
+        return std::nullopt;
+    }
+    return content;
+}
+
+}  // namespace
+
+std::optional<MessageFormat> parseMessageFromFile(const std::filesystem::path &inputFile,
+                                                  google::protobuf::Message &message) {
+    MappedFile file;
+    std::string decompressed;
+    auto content = loadFile(inputFile, file, decompressed);
+    if (!content.has_value()) {
+        return std::nullopt;
+    }
+    const auto *begin = content->data();
+    const auto *end = begin + content->size();
+    auto size = static_cast<int>(content->size());
+
+    auto looksLikeText = isText(begin, end);
+    if (looksLikeText) {
+        google::protobuf::io::ArrayInputStream input(begin, size);
+        if (google::protobuf::TextFormat::Parse(&input, &message)) {
+            return MessageFormat::Text;
+        }
+    }
+    // Short binary messages may consist of printable characters only.
+    if (auto format = parseBinary(begin, size, message)) {
+        return format;
+    }
+    if (looksLikeText) {
+        error("Failed to parse file %1% as text format %2%", inputFile.c_str(),
+              message.GetTypeName());
+    } else {
+        error("Failed to parse file %1% as binary or length-delimited %2%", inputFile.c_str(),
+              message.GetTypeName());
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> parseAnyMessageFromFile(
+    const std::filesystem::path &inputFile,
+    const std::vector<google::protobuf::Message *> &candidates) {
+    BUG_CHECK(!candidates.empty(), "No message types to parse %1% into.", inputFile.c_str());
+    MappedFile file;
+    std::string decompressed;
+    auto content = loadFile(inputFile, file, decompressed);
+    if (!content.has_value()) {
+        return std::nullopt;
+    }
+    const auto *begin = content->data();
+    const auto *end = begin + content->size();
+    auto size = static_cast<int>(content->size());
+
+    if (isText(begin, end)) {
+        // Pick the message type by the name of the first field, so that parsing only happens once.
+        auto fieldName = std::string(getFirstTextField(begin, end));
+        for (size_t idx = 0; idx < candidates.size(); ++idx) {
+            auto *candidate = candidates.at(idx);
+            if (!fieldName.empty() &&
+                candidate->GetDescriptor()->FindFieldByName(fieldName) == nullptr) {
+                continue;
+            }
+            google::protobuf::io::ArrayInputStream input(begin, size);
+            if (!google::protobuf::TextFormat::Parse(&input, candidate)) {
+                error("Failed to parse file %1% as text format %2%", inputFile.c_str(),
+                      candidate->GetTypeName());
+                return std::nullopt;
+            }
+            return idx;
+        }
+        error("File %1% does not contain any of the expected message types", inputFile.c_str());
+        return std::nullopt;
+    }
+    // Binary messages of the wrong type usually still parse, but parseBinary rejects them because
+    // their fields end up unknown.
+    for (size_t idx = 0; idx < candidates.size(); ++idx) {
+        if (parseBinary(begin, size, *candidates.at(idx)).has_value()) {
+            return idx;
+        }
+    }
+    error("File %1% does not contain any of the expected message types", inputFile.c_str());
+    return std::nullopt;
+}
+
+}  // namespace P4::P4Tools::RtSmith::Protobuf
@@ -1,17 +1,17 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_CONTROL_PLANE_PROTOBUF_UTILS_H_
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_CONTROL_PLANE_PROTOBUF_UTILS_H_
 
-#include <fcntl.h>
-
-#include <google/protobuf/io/zero_copy_stream_impl.h>
-#include <google/protobuf/text_format.h>
+#include <google/protobuf/message.h>
 
 #include <filesystem>
+#include <optional>
+#include <vector>
 
 #include "backends/p4tools/common/lib/logging.h"
 #include "backends/p4tools/modules/rtsmith/core/util.h"
 #include "lib/big_int.h"
 #include "lib/error.h"
+#include "lib/log.h"
 
 namespace P4::P4Tools::RtSmith::Protobuf {
 
@@ -25,28 +25,43 @@ inline big_int stringToBigInt(const std::string &valueString) {
     return value;
 }
 
-/// Deserialize a .proto file into a P4Runtime-compliant Protobuf object.
+/// The encodings `parseMessageFromFile` detects.
+enum class MessageFormat { Text, Binary, LengthDelimited };
+
+/// @brief Parse the file at @param inputFile into @param message. The file is memory-mapped and
+/// its format is detected from its content: A file that only contains printable characters is
+/// parsed as text format. Otherwise, or if it does not parse as text format, the file is parsed as
+/// a sequence of length-delimited messages if the length prefixes frame the file exactly and the
+/// messages have no unknown fields, and as a single binary message without unknown fields if not.
+/// Length-delimited messages are merged into @param message. Gzip-compressed files are
+/// decompressed first.
+/// @return The detected format or std::nullopt if the file can not be read or parsed.
+std::optional<MessageFormat> parseMessageFromFile(const std::filesystem::path &inputFile,
+                                                  google::protobuf::Message &message);
+
+/// @brief Parse the file at @param inputFile into the first of @param candidates that fits it. The
+/// format is detected as in `parseMessageFromFile`. A text file fits a message type that has a
+/// field named like the first field of the file, a binary file fits a message type if it parses
+/// without unknown fields.
+/// @return The index of the candidate or std::nullopt if the file can not be read or parsed.
+std::optional<size_t> parseAnyMessageFromFile(
+    const std::filesystem::path &inputFile,
+    const std::vector<google::protobuf::Message *> &candidates);
+
+/// Deserialize a .proto file into a P4Runtime-compliant Protobuf object. The file may be encoded
+/// in text format, in binary, or as length-delimited binary messages, and may be gzip-compressed.
 template <class T>
 [[nodiscard]] static std::optional<T> deserializeObjectFromFile(
     const std::filesystem::path &inputFile) {
     T protoObject;
-
-    // Parse the input file into the Protobuf object.
-    int fd = open(inputFile.c_str(),
-                  O_RDONLY);  // NOLINT, we are forced to use open here.
-    RETURN_IF_FALSE_WITH_MESSAGE(fd > 0, std::nullopt,
-                                 error("Failed to open file %1%", inputFile.c_str()));
-    google::protobuf::io::ZeroCopyInputStream *input =
-        new google::protobuf::io::FileInputStream(fd);
-
-    RETURN_IF_FALSE_WITH_MESSAGE(google::protobuf::TextFormat::Parse(input, &protoObject),
-                                 std::nullopt,
-                                 error("Failed to parse configuration \"%1%\" for file %2%",
-                                       protoObject.ShortDebugString(), inputFile.c_str()));
-
-    printFeature("p4rtsmith_protobuf", 4, "Parsed configuration: %1%", protoObject.DebugString());
-    // Close the open file.
-    close(fd);
+    if (!parseMessageFromFile(inputFile, protoObject).has_value()) {
+        return std::nullopt;
+    }
+    // Printing large objects is expensive, only do it if the feature is enabled.
+    if (Log::fileLogLevelIsAtLeast("p4rtsmith_protobuf", 4)) {
+        printFeature("p4rtsmith_protobuf", 4, "Parsed configuration: %1%",
+                     protoObject.DebugString());
+    }
     return protoObject;
 }
 
@@ -0,0 +1,179 @@
+#include "backends/p4tools/modules/rtsmith/core/distributions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "lib/exceptions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+double getRandUnit() {
+    // 53 random bits fill the mantissa of a double.
+    static constexpr uint64_t RESOLUTION = uint64_t(1) << 53;
+    return static_cast<double>(Utils::getRandInt(RESOLUTION - 1)) /
+           static_cast<double>(RESOLUTION);
+}
+
+KeyPopularity KeyPopularity::uniform() { return {Kind::Uniform, 0, 0}; }
+
+KeyPopularity KeyPopularity::zipf(double exponent) {
+    BUG_CHECK(exponent > 0, "The Zipf exponent must be positive.");
+    return {Kind::Zipf, exponent, 0};
+}
+
+KeyPopularity KeyPopularity::hotCold(double hotFraction, double hotProbability) {
+    BUG_CHECK(hotFraction >= 0 && hotFraction <= 1, "The hot fraction must be in [0, 1].");
+    BUG_CHECK(hotProbability >= 0 && hotProbability <= 1,
+              "The hot probability must be in [0, 1].");
+    return {Kind::HotCold, hotFraction, hotProbability};
+}
+
+size_t KeyPopularity::sample(size_t numEntries) const {
+    BUG_CHECK(numEntries > 0, "Can not sample from an empty table.");
+    switch (kind) {
+        case Kind::Uniform:
+            return Utils::getRandInt(numEntries - 1);
+        case Kind::Zipf:
+            return sampleZipf(numEntries) - 1;
+        case Kind::HotCold: {
+            // The hot set contains at least one entry.
+            auto numHot = std::clamp<size_t>(
+                static_cast<size_t>(std::ceil(first * static_cast<double>(numEntries))), 1,
+                numEntries);
+            if (numHot == numEntries || getRandUnit() < second) {
+                return Utils::getRandInt(numHot - 1);
+            }
+            return Utils::getRandInt(static_cast<int64_t>(numHot),
+                                     static_cast<int64_t>(numEntries) - 1);
+        }
+    }
+    BUG("Unknown key popularity kind.");
+}
+
+namespace {
+
+/// @returns log1p(x) / x, also for x close to 0.
+double helper1(double x) {
+    if (std::abs(x) > 1e-8) {
+        return std::log1p(x) / x;
+    }
+    return 1 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+/// @returns expm1(x) / x, also for x close to 0.
+double helper2(double x) {
+    if (std::abs(x) > 1e-8) {
+        return std::expm1(x) / x;
+    }
+    return 1 + x * 0.5 * (1 + x * 1.0 / 3.0 * (1 + 0.25 * x));
+}
+
+}  // namespace
+
+size_t KeyPopularity::sampleZipf(size_t numEntries) const {
+    // Rejection-inversion sampling, see W. Hörmann and G. Derflinger, "Rejection-inversion to
+    // generate variates from monotone discrete distributions", 1996. The expected number of
+    // iterations is bounded by a small constant for all exponents and table sizes.
+    const double exponent = first;
+    // h(x) = x^-s, hIntegral is an antiderivative of h and hIntegralInverse its inverse.
+    auto h = [exponent](double x) { return std::exp(-exponent * std::log(x)); };
+    auto hIntegral = [exponent](double x) {
+        double logX = std::log(x);
+        return helper2((1 - exponent) * logX) * logX;
+    };
+    auto hIntegralInverse = [exponent](double x) {
+        double t = x * (1 - exponent);
+        t = std::max(t, -1.0);
+        return std::exp(helper1(t) * x);
+    };
+
+    const double hIntegralX1 = hIntegral(1.5) - 1;
+    const double hIntegralN = hIntegral(static_cast<double>(numEntries) + 0.5);
+    const double s = 2 - hIntegralInverse(hIntegral(2.5) - h(2));
+    while (true) {
+        double u = hIntegralN + getRandUnit() * (hIntegralX1 - hIntegralN);
+        double x = hIntegralInverse(u);
+        auto k = static_cast<size_t>(std::clamp(x + 0.5, 1.0, static_cast<double>(numEntries)));
+        auto kValue = static_cast<double>(k);
+        if (kValue - x <= s || u >= hIntegral(kValue + 0.5) - h(kValue)) {
+            return k;
+        }
+    }
+}
+
+ArrivalProcess ArrivalProcess::uniform(uint64_t minDelay, uint64_t maxDelay) {
+    BUG_CHECK(minDelay <= maxDelay, "The minimum delay must not exceed the maximum delay.");
+    return {Kind::Uniform, static_cast<double>(minDelay), static_cast<double>(maxDelay), 0};
+}
+
+ArrivalProcess ArrivalProcess::poisson(double rate) {
+    BUG_CHECK(rate > 0, "The rate of a Poisson process must be positive.");
+    return {Kind::Poisson, rate, 0, 0};
+}
+
+ArrivalProcess ArrivalProcess::onOff(uint64_t burstSteps, uint64_t burstDelay,
+                                     uint64_t idleDelay) {
+    BUG_CHECK(burstSteps > 0, "A burst must contain at least one time step.");
+    return {Kind::OnOff, static_cast<double>(burstSteps), static_cast<double>(burstDelay),
+            static_cast<double>(idleDelay)};
+}
+
+ArrivalProcess ArrivalProcess::ramp(uint64_t startDelay, uint64_t endDelay) {
+    return {Kind::Ramp, static_cast<double>(startDelay), static_cast<double>(endDelay), 0};
+}
+
+uint64_t ArrivalProcess::sampleDelay(size_t step, size_t numSteps) const {
+    switch (kind) {
+        case Kind::Uniform:
+            return Utils::getRandInt(static_cast<int64_t>(first), static_cast<int64_t>(second));
+        case Kind::Poisson:
+            // Inversion of the exponential distribution with mean 1 / rate seconds.
+            return static_cast<uint64_t>(-std::log1p(-getRandUnit()) / first * 1e6);
+        case Kind::OnOff:
+            return step % static_cast<size_t>(first) == 0 ? static_cast<uint64_t>(third)
+                                                           : static_cast<uint64_t>(second);
+        case Kind::Ramp: {
+            if (numSteps <= 1) {
+                return static_cast<uint64_t>(first);
+            }
+            auto progress = static_cast<double>(step) / static_cast<double>(numSteps - 1);
+            return static_cast<uint64_t>(std::llround(first + (second - first) * progress));
+        }
+    }
+    BUG("Unknown arrival process kind.");
+}
+
+StepSize StepSize::fixed(uint64_t size) { return {Kind::Fixed, static_cast<double>(size), 0}; }
+
+StepSize StepSize::uniform(uint64_t minSize, uint64_t maxSize) {
+    BUG_CHECK(minSize <= maxSize, "The minimum step size must not exceed the maximum step size.");
+    return {Kind::Uniform, static_cast<double>(minSize), static_cast<double>(maxSize)};
+}
+
+StepSize StepSize::geometric(double meanSize) {
+    BUG_CHECK(meanSize >= 1, "The mean step size must be at least 1.");
+    return {Kind::Geometric, meanSize, 0};
+}
+
+uint64_t StepSize::sample() const {
+    switch (kind) {
+        case Kind::Fixed:
+            return static_cast<uint64_t>(first);
+        case Kind::Uniform:
+            return Utils::getRandInt(static_cast<int64_t>(first), static_cast<int64_t>(second));
+        case Kind::Geometric: {
+            // Inversion of the geometric distribution on {1, 2, ...} with success probability
+            // 1 / mean.
+            if (first <= 1) {
+                return 1;
+            }
+            auto logFailure = std::log1p(-1 / first);
+            return 1 + static_cast<uint64_t>(std::floor(std::log1p(-getRandUnit()) / logFailure));
+        }
+    }
+    BUG("Unknown step size kind.");
+}
+
+}  // namespace P4::P4Tools::RtSmith
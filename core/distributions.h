@@ -0,0 +1,164 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_DISTRIBUTIONS_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_DISTRIBUTIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace P4::P4Tools::RtSmith {
+
+/// @returns a number drawn uniformly from [0, 1) using the random number generator of P4Tools.
+double getRandUnit();
+
+/// Decides which of the installed entries of a table an update hits. Entries are identified by
+/// their position in the table state, position 0 is the most popular one.
+class KeyPopularity {
+ public:
+    enum class Kind {
+        /// Every entry is equally likely.
+        Uniform,
+        /// The probability of the entry at rank k (starting at 1) is proportional to 1 / k^s.
+        Zipf,
+        /// A fixed fraction of the entries, the hot set, receives a fixed fraction of the updates.
+        /// Entries within the hot set and within the cold set are equally likely.
+        HotCold,
+    };
+
+    /// @returns a model that picks every entry with the same probability.
+    static KeyPopularity uniform();
+
+    /// @returns a Zipf model with exponent @param exponent, which must be positive.
+    static KeyPopularity zipf(double exponent);
+
+    /// @returns a model where a fraction @param hotFraction of the entries receives a fraction
+    /// @param hotProbability of the updates. Both must be in [0, 1].
+    static KeyPopularity hotCold(double hotFraction, double hotProbability);
+
+    /// @returns the kind of the model.
+    [[nodiscard]] Kind getKind() const { return kind; }
+
+    /// @returns a position in [0, @param numEntries). @param numEntries must be positive.
+    /// Sampling takes expected constant time, independent of the number of entries.
+    [[nodiscard]] size_t sample(size_t numEntries) const;
+
+ private:
+    KeyPopularity(Kind kind, double first, double second)
+        : kind(kind), first(first), second(second) {}
+
+    Kind kind;
+
+    /// The exponent for Zipf models, the hot fraction for hot/cold models.
+    double first;
+
+    /// The hot probability for hot/cold models.
+    double second;
+
+    /// @returns a rank in [1, @param numEntries] drawn from the Zipf distribution.
+    [[nodiscard]] size_t sampleZipf(size_t numEntries) const;
+};
+
+/// Produces the delays between the time steps of an update series.
+class ArrivalProcess {
+ public:
+    enum class Kind {
+        /// Delays are drawn uniformly from a range.
+        Uniform,
+        /// Time steps arrive as a Poisson process, delays are exponentially distributed.
+        Poisson,
+        /// Bursts of time steps with a short delay are separated by a long idle delay.
+        OnOff,
+        /// The delay changes linearly from a start to an end value over the time steps.
+        Ramp,
+    };
+
+    /// @returns a process with delays drawn uniformly from [@param minDelay, @param maxDelay].
+    static ArrivalProcess uniform(uint64_t minDelay, uint64_t maxDelay);
+
+    /// @returns a Poisson process with @param rate time steps per second. Must be positive.
+    static ArrivalProcess poisson(double rate);
+
+    /// @returns a process with bursts of @param burstSteps time steps, @param burstDelay apart.
+    /// The first time step of each burst follows @param idleDelay after the previous burst.
+    static ArrivalProcess onOff(uint64_t burstSteps, uint64_t burstDelay, uint64_t idleDelay);
+
+    /// @returns a process whose delay changes linearly from @param startDelay at the first time
+    /// step to @param endDelay at the last time step.
+    static ArrivalProcess ramp(uint64_t startDelay, uint64_t endDelay);
+
+    /// @returns the kind of the process.
+    [[nodiscard]] Kind getKind() const { return kind; }
+
+    /// @returns the delay (in microseconds) before time step @param step of @param numSteps
+    /// time steps.
+    [[nodiscard]] uint64_t sampleDelay(size_t step, size_t numSteps) const;
+
+ private:
+    ArrivalProcess(Kind kind, double first, double second, double third)
+        : kind(kind), first(first), second(second), third(third) {}
+
+    Kind kind;
+
+    /// The parameters of the process, in the order of the arguments of its factory.
+    double first;
+    double second;
+    double third;
+};
+
+/// Produces the number of updates per table of a time step.
+class StepSize {
+ public:
+    enum class Kind {
+        /// Every time step has the same size.
+        Fixed,
+        /// Sizes are drawn uniformly from a range.
+        Uniform,
+        /// Sizes are geometrically distributed. Most steps are small, a few are large.
+        Geometric,
+    };
+
+    /// @returns a distribution that always produces @param size.
+    static StepSize fixed(uint64_t size);
+
+    /// @returns a distribution of sizes drawn uniformly from [@param minSize, @param maxSize].
+    static StepSize uniform(uint64_t minSize, uint64_t maxSize);
+
+    /// @returns a geometric distribution of sizes of at least 1 with mean @param meanSize, which
+    /// must be at least 1.
+    static StepSize geometric(double meanSize);
+
+    /// @returns the kind of the distribution.
+    [[nodiscard]] Kind getKind() const { return kind; }
+
+    /// @returns the size of a time step.
+    [[nodiscard]] uint64_t sample() const;
+
+ private:
+    StepSize(Kind kind, double first, double second) : kind(kind), first(first), second(second) {}
+
+    Kind kind;
+
+    /// The parameters of the distribution, in the order of the arguments of its factory.
+    double first;
+    double second;
+};
+
+/// A phase of an update series: A number of time steps with the same arrival process and step
+/// size distribution.
+struct WorkloadPhase {
+    /// The number of time steps of the phase.
+    size_t numSteps;
+
+    /// Produces the delays between the time steps of the phase.
+    ArrivalProcess arrivalProcess;
+
+    /// Produces the number of updates per table of each time step of the phase.
+    StepSize stepSize;
+
+    /// Whether the phase only inserts table entries. Used to bulk-load tables. Unlike in the
+    /// initial configuration, the step size still bounds the updates per table, and the other
+    /// objects are updated as in any other time step.
+    bool insertOnly = false;
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_DISTRIBUTIONS_H_ */
@@ -1,6 +1,14 @@
 #include "backends/p4tools/modules/rtsmith/core/fuzzer.h"
 
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/rtsmith/core/control_plane/protobuf_utils.h"
+#include "backends/p4tools/modules/rtsmith/core/util.h"
 #include "control-plane/bytestrings.h"
 #include "control-plane/p4infoApi.h"
 
@@ -12,10 +20,11 @@ p4::v1::FieldMatch_Exact P4RuntimeFuzzer::produceFieldMatch_Exact(int bitwidth)
     return protoExact;
 }
 
-p4::v1::FieldMatch_LPM P4RuntimeFuzzer::produceFieldMatch_LPM(int bitwidth) {
+p4::v1::FieldMatch_LPM P4RuntimeFuzzer::produceFieldMatch_LPM(int bitwidth,
+                                                              const TablePolicy &policy) {
     p4::v1::FieldMatch_LPM protoLPM;
     protoLPM.set_value(produceBytes(bitwidth));
-    protoLPM.set_prefix_len(Utils::getRandInt(0, bitwidth));
+    protoLPM.set_prefix_len(producePrefixLength(bitwidth, policy));
     return protoLPM;
 }
 
@@ -71,6 +80,230 @@ p4::v1::Action P4RuntimeFuzzer::produceTableAction(
     return protoAction;
 }
 
+int32_t P4RuntimeFuzzer::produceMemberWeight() {
+    return static_cast<int32_t>(
+        Utils::getRandInt(1, getProgramInfo().getFuzzerConfig().getMaxMemberWeight()));
+}
+
+bool P4RuntimeFuzzer::usesOneShotProgramming(const p4::config::v1::ActionProfile &profile) {
+    if (!profile.with_selector()) {
+        return false;
+    }
+    auto it = oneShotSelectors.find(profile.preamble().name());
+    if (it == oneShotSelectors.end()) {
+        it = oneShotSelectors.emplace(profile.preamble().name(), Utils::getRandInt(0, 1) == 0)
+                 .first;
+    }
+    return it->second;
+}
+
+p4::v1::ActionProfileMember P4RuntimeFuzzer::produceActionProfileMember(
+    const p4::config::v1::ActionProfile &profile, uint32_t memberId,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &actionRefs,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    p4::v1::ActionProfileMember protoMember;
+    protoMember.set_action_profile_id(profile.preamble().id());
+    protoMember.set_member_id(memberId);
+    *protoMember.mutable_action() = produceTableAction(actionRefs, actions);
+    return protoMember;
+}
+
+p4::v1::ActionProfileGroup P4RuntimeFuzzer::produceActionProfileGroup(
+    const p4::config::v1::ActionProfile &profile, uint32_t groupId,
+    const TableState<p4::v1::ActionProfileMember> &members) {
+    p4::v1::ActionProfileGroup protoGroup;
+    protoGroup.set_action_profile_id(profile.preamble().id());
+    protoGroup.set_group_id(groupId);
+    protoGroup.set_max_size(getMaxGroupSize(profile));
+    auto numMembers = members.size();
+    for (auto position : sampleDistinctIds(produceGroupSize(profile, numMembers), numMembers)) {
+        auto *protoMember = protoGroup.add_members();
+        protoMember->set_member_id(members.entryAt(position - 1).member_id());
+        protoMember->set_weight(produceMemberWeight());
+    }
+    return protoGroup;
+}
+
+void P4RuntimeFuzzer::churnActionProfileGroup(
+    const p4::config::v1::ActionProfile &profile, p4::v1::ActionProfileGroup &group,
+    const TableState<p4::v1::ActionProfileMember> &members) {
+    auto groupSize = static_cast<int64_t>(group.members_size());
+    bool canGrow =
+        groupSize < getMaxGroupSize(profile) && groupSize < static_cast<int64_t>(members.size());
+    bool canShrink =
+        groupSize > std::max(getProgramInfo().getFuzzerConfig().getMinGroupSize(), 1);
+    if (canGrow && (!canShrink || Utils::getRandInt(0, 1) == 0)) {
+        // Add a member that is not part of the group yet.
+        std::vector<uint32_t> candidates;
+        for (size_t position = 0; position < members.size(); position++) {
+            auto memberId = members.entryAt(position).member_id();
+            if (std::none_of(group.members().begin(), group.members().end(),
+                             [memberId](const p4::v1::ActionProfileGroup::Member &member) {
+                                 return member.member_id() == memberId;
+                             })) {
+                candidates.push_back(memberId);
+            }
+        }
+        auto *protoMember = group.add_members();
+        protoMember->set_member_id(candidates.at(Utils::getRandInt(candidates.size() - 1)));
+        protoMember->set_weight(produceMemberWeight());
+    } else if (canShrink) {
+        auto *members = group.mutable_members();
+        members->erase(members->begin() + Utils::getRandInt(members->size() - 1));
+    }
+}
+
+p4::v1::ActionProfileActionSet P4RuntimeFuzzer::produceActionProfileActionSet(
+    const p4::config::v1::ActionProfile &profile,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &actionRefs,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    p4::v1::ActionProfileActionSet protoActionSet;
+    auto setSize = produceGroupSize(profile, getMaxGroupSize(profile));
+    for (size_t idx = 0; idx < setSize; idx++) {
+        auto *protoAction = protoActionSet.add_action_profile_actions();
+        *protoAction->mutable_action() = produceTableAction(actionRefs, actions);
+        protoAction->set_weight(produceMemberWeight());
+    }
+    return protoActionSet;
+}
+
+p4::v1::TableAction P4RuntimeFuzzer::produceEntryAction(
+    const p4::config::v1::Table &table,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    p4::v1::TableAction protoTableAction;
+    if (table.implementation_id() == 0) {
+        *protoTableAction.mutable_action() = produceTableAction(table.action_refs(), actions);
+        return protoTableAction;
+    }
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    const auto &profile = findActionProfile(*p4Info, table.implementation_id());
+    if (usesOneShotProgramming(profile)) {
+        *protoTableAction.mutable_action_profile_action_set() =
+            produceActionProfileActionSet(profile, table.action_refs(), actions);
+        return protoTableAction;
+    }
+    const auto &members = actionProfileMembers[profile.preamble().name()];
+    const auto &groups = actionProfileGroups[profile.preamble().name()];
+    BUG_CHECK(!members.empty(), "Action profile %1% has no members.", profile.preamble().name());
+    // Entries of tables with a selector refer to a group or a single member with equal chance.
+    if (!groups.empty() && Utils::getRandInt(0, 1) == 0) {
+        protoTableAction.set_action_profile_group_id(
+            groups.entryAt(groups.samplePosition()).group_id());
+    } else {
+        protoTableAction.set_action_profile_member_id(
+            members.entryAt(members.samplePosition()).member_id());
+    }
+    return protoTableAction;
+}
+
+void P4RuntimeFuzzer::produceActionProfileUpdates(
+    bool isInitialConfig, WriteRequestBatcher<p4::v1::WriteRequest> &batcher) {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    const auto actions = p4Info->actions();
+
+    // Members first, so that groups and table entries can refer to them.
+    for (const auto &profile : p4Info->action_profiles()) {
+        const auto *table = findActionProfileTable(*p4Info, profile.preamble().id());
+        if (table == nullptr || usesOneShotProgramming(profile)) {
+            continue;
+        }
+        auto &members = actionProfileMembers[profile.preamble().name()];
+        auto &nextMemberId = nextMemberIds.try_emplace(profile.preamble().name(), 1).first->second;
+        auto maxMembers = static_cast<size_t>(fuzzerConfig.getMaxActionProfileMembers());
+        if (profile.size() > 0) {
+            maxMembers = std::min(maxMembers, static_cast<size_t>(profile.size()));
+        }
+        if (maxMembers == 0) {
+            continue;
+        }
+        if (isInitialConfig) {
+            while (members.size() < maxMembers) {
+                auto memberId = nextMemberId++;
+                auto member =
+                    produceActionProfileMember(profile, memberId, table->action_refs(), actions);
+                p4::v1::Update update;
+                update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+                *update.mutable_entity()->mutable_action_profile_member() = member;
+                batcher.add(std::move(update));
+                members.insert(std::to_string(memberId), std::move(member));
+            }
+            continue;
+        }
+        if (Utils::getRandInt(0, 1) == 0) {
+            continue;
+        }
+        // Members are never deleted, deletions modify the action of a member instead.
+        p4::v1::Update update;
+        if (members.size() < maxMembers &&
+            pickUpdateOperation(!members.empty()) == UpdateOperation::Insert) {
+            auto memberId = nextMemberId++;
+            auto member =
+                produceActionProfileMember(profile, memberId, table->action_refs(), actions);
+            update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+            *update.mutable_entity()->mutable_action_profile_member() = member;
+            members.insert(std::to_string(memberId), std::move(member));
+        } else if (!members.empty()) {
+            auto &member = members.entryAt(members.samplePosition());
+            *member.mutable_action() = produceTableAction(table->action_refs(), actions);
+            update.set_type(p4::v1::Update_Type::Update_Type_MODIFY);
+            *update.mutable_entity()->mutable_action_profile_member() = member;
+        } else {
+            continue;
+        }
+        batcher.add(std::move(update));
+    }
+    batcher.flush();
+
+    // Groups second, so that table entries can refer to them.
+    for (const auto &profile : p4Info->action_profiles()) {
+        const auto &members = actionProfileMembers[profile.preamble().name()];
+        if (!profile.with_selector() || members.empty()) {
+            continue;
+        }
+        auto &groups = actionProfileGroups[profile.preamble().name()];
+        auto &nextGroupId = nextGroupIds.try_emplace(profile.preamble().name(), 1).first->second;
+        auto maxGroups = static_cast<size_t>(fuzzerConfig.getMaxSelectorGroups());
+        if (maxGroups == 0) {
+            continue;
+        }
+        if (isInitialConfig) {
+            while (groups.size() < maxGroups) {
+                auto groupId = nextGroupId++;
+                auto group = produceActionProfileGroup(profile, groupId, members);
+                p4::v1::Update update;
+                update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+                *update.mutable_entity()->mutable_action_profile_group() = group;
+                batcher.add(std::move(update));
+                groups.insert(std::to_string(groupId), std::move(group));
+            }
+            continue;
+        }
+        if (Utils::getRandInt(0, 1) == 0) {
+            continue;
+        }
+        // Groups are never deleted, the update series churns their membership instead.
+        p4::v1::Update update;
+        if (groups.size() < maxGroups &&
+            pickUpdateOperation(!groups.empty()) == UpdateOperation::Insert) {
+            auto groupId = nextGroupId++;
+            auto group = produceActionProfileGroup(profile, groupId, members);
+            update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+            *update.mutable_entity()->mutable_action_profile_group() = group;
+            groups.insert(std::to_string(groupId), std::move(group));
+        } else if (!groups.empty()) {
+            auto &group = groups.entryAt(groups.samplePosition());
+            churnActionProfileGroup(profile, group, members);
+            update.set_type(p4::v1::Update_Type::Update_Type_MODIFY);
+            *update.mutable_entity()->mutable_action_profile_group() = group;
+        } else {
+            continue;
+        }
+        batcher.add(std::move(update));
+    }
+    batcher.flush();
+}
+
 uint32_t P4RuntimeFuzzer::producePriority(
     const google::protobuf::RepeatedPtrField<p4::config::v1::MatchField> &matchFields) {
     for (const auto &match : matchFields) {
@@ -87,7 +320,8 @@ uint32_t P4RuntimeFuzzer::producePriority(
     return 0;
 }
 
-p4::v1::FieldMatch P4RuntimeFuzzer::produceMatchField(p4::config::v1::MatchField &match) {
+p4::v1::FieldMatch P4RuntimeFuzzer::produceMatchField(p4::config::v1::MatchField &match,
+                                                      const TablePolicy &policy) {
     p4::v1::FieldMatch protoMatch;
     protoMatch.set_field_id(match.id());
 
@@ -99,7 +333,7 @@ p4::v1::FieldMatch P4RuntimeFuzzer::produceMatchField(p4::config::v1::MatchField
             protoMatch.mutable_exact()->CopyFrom(produceFieldMatch_Exact(bitwidth));
             break;
         case p4::config::v1::MatchField::LPM:
-            protoMatch.mutable_lpm()->CopyFrom(produceFieldMatch_LPM(bitwidth));
+            protoMatch.mutable_lpm()->CopyFrom(produceFieldMatch_LPM(bitwidth, policy));
             break;
         case p4::config::v1::MatchField::TERNARY:
             protoMatch.mutable_ternary()->CopyFrom(produceFieldMatch_Ternary(bitwidth));
@@ -119,7 +353,8 @@ p4::v1::FieldMatch P4RuntimeFuzzer::produceMatchField(p4::config::v1::MatchField
 
 p4::v1::TableEntry P4RuntimeFuzzer::produceTableEntry(
     const p4::config::v1::Table &table,
-    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+    const TablePolicy &policy) {
     p4::v1::TableEntry protoEntry;
 
     // set table id
@@ -129,7 +364,11 @@ p4::v1::TableEntry P4RuntimeFuzzer::produceTableEntry(
     // add matches
     const auto &matchFields = table.match_fields();
     for (auto match : matchFields) {
-        protoEntry.add_match()->CopyFrom(produceMatchField(match));
+        // P4Runtime expresses a ternary wildcard by omitting the field.
+        if (match.match_type() == p4::config::v1::MatchField::TERNARY && produceWildcard(policy)) {
+            continue;
+        }
+        protoEntry.add_match()->CopyFrom(produceMatchField(match, policy));
     }
 
     // set priority
@@ -137,80 +376,941 @@ p4::v1::TableEntry P4RuntimeFuzzer::produceTableEntry(
     protoEntry.set_priority(priority);
 
     // add action
-    const auto &action_refs = table.action_refs();
-    auto protoAction = produceTableAction(action_refs, actions);
-    *protoEntry.mutable_action()->mutable_action() = protoAction;
+    *protoEntry.mutable_action() = produceEntryAction(table, actions);
     return protoEntry;
 }
 
-std::unique_ptr<p4::v1::WriteRequest> P4RuntimeFuzzer::produceWriteRequest(bool isInitialConfig) {
+namespace {
+
+/// @returns a mask with the lowest @param bitwidth bits set.
+big_int fullMask(int bitwidth) { return (big_int(1) << bitwidth) - 1; }
+
+/// @returns a mask with the @param prefixLen most significant of @param bitwidth bits set.
+big_int prefixMask(int bitwidth, int prefixLen) {
+    return fullMask(prefixLen) << (bitwidth - prefixLen);
+}
+
+}  // namespace
+
+EntryRegion P4RuntimeFuzzer::computeEntryRegion(const p4::config::v1::Table &table,
+                                                const p4::v1::TableEntry &entry) {
+    EntryRegion region;
+    for (const auto &matchField : table.match_fields()) {
+        auto bitwidth = matchField.bitwidth();
+        auto protoMatch = std::find_if(entry.match().begin(), entry.match().end(),
+                                       [&matchField](const p4::v1::FieldMatch &match) {
+                                           return match.field_id() == matchField.id();
+                                       });
+        // Omitted fields are wildcards.
+        if (protoMatch == entry.match().end()) {
+            if (matchField.match_type() == p4::config::v1::MatchField::RANGE) {
+                region.push_back(FieldRegion::interval(0, fullMask(bitwidth)));
+            } else {
+                region.push_back(FieldRegion::masked(0, 0));
+            }
+            continue;
+        }
+        switch (protoMatch->field_match_type_case()) {
+            case p4::v1::FieldMatch::kExact:
+                region.push_back(FieldRegion::masked(
+                    Protobuf::stringToBigInt(protoMatch->exact().value()), fullMask(bitwidth)));
+                break;
+            case p4::v1::FieldMatch::kLpm:
+                region.push_back(FieldRegion::masked(
+                    Protobuf::stringToBigInt(protoMatch->lpm().value()),
+                    prefixMask(bitwidth, protoMatch->lpm().prefix_len())));
+                break;
+            case p4::v1::FieldMatch::kTernary:
+                region.push_back(
+                    FieldRegion::masked(Protobuf::stringToBigInt(protoMatch->ternary().value()),
+                                        Protobuf::stringToBigInt(protoMatch->ternary().mask())));
+                break;
+            case p4::v1::FieldMatch::kRange:
+                region.push_back(
+                    FieldRegion::interval(Protobuf::stringToBigInt(protoMatch->range().low()),
+                                          Protobuf::stringToBigInt(protoMatch->range().high())));
+                break;
+            case p4::v1::FieldMatch::kOptional:
+                region.push_back(FieldRegion::masked(
+                    Protobuf::stringToBigInt(protoMatch->optional().value()), fullMask(bitwidth)));
+                break;
+            default:
+                P4C_UNIMPLEMENTED("Match type %1% not supported for overlap computation yet",
+                                  p4::config::v1::MatchField::MatchType_Name(
+                                      matchField.match_type()));
+        }
+    }
+    return region;
+}
+
+OverlapIndex *P4RuntimeFuzzer::getOverlapIndex(const p4::config::v1::Table &table,
+                                               const TablePolicy &policy) {
+    const auto &tableName = table.preamble().name();
+    auto it = overlapIndices.find(tableName);
+    if (it != overlapIndices.end()) {
+        return &it->second;
+    }
+    // Only ternary and range entries can partially overlap.
+    if (!policy.overlapTarget.has_value() ||
+        !(tableHasFieldType(table, p4::config::v1::MatchField::TERNARY) ||
+          tableHasFieldType(table, p4::config::v1::MatchField::RANGE))) {
+        return nullptr;
+    }
+    std::vector<FieldRegion::Kind> fieldKinds;
+    std::vector<int> fieldWidths;
+    for (const auto &matchField : table.match_fields()) {
+        fieldKinds.push_back(matchField.match_type() == p4::config::v1::MatchField::RANGE
+                                 ? FieldRegion::Kind::Interval
+                                 : FieldRegion::Kind::Masked);
+        fieldWidths.push_back(matchField.bitwidth());
+    }
+    return &overlapIndices.try_emplace(tableName, std::move(fieldKinds), std::move(fieldWidths))
+                .first->second;
+}
+
+p4::v1::TableEntry P4RuntimeFuzzer::produceOverlappingTableEntry(
+    const p4::config::v1::Table &table,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+    const EntryRegion &anchor, const TablePolicy &policy) {
+    // All key fields are derived from the anchor, so none of them is omitted.
+    auto keyPolicy = policy;
+    keyPolicy.wildcardProbability = 0;
+    auto protoEntry = produceTableEntry(table, actions, keyPolicy);
+    const auto &matchFields = table.match_fields();
+    for (int idx = 0; idx < matchFields.size(); idx++) {
+        const auto &matchField = matchFields.Get(idx);
+        const auto &anchorField = anchor.at(idx);
+        auto bitwidth = matchField.bitwidth();
+        auto *protoMatch = protoEntry.mutable_match(idx);
+        switch (matchField.match_type()) {
+            // Exact and optional fields only overlap if they are identical.
+            case p4::config::v1::MatchField::EXACT:
+                protoMatch->mutable_exact()->set_value(produceBytes(bitwidth, anchorField.first));
+                break;
+            case p4::config::v1::MatchField::OPTIONAL:
+                protoMatch->mutable_optional()->set_value(
+                    produceBytes(bitwidth, anchorField.first));
+                break;
+            // Prefixes overlap if they agree on their common bits.
+            case p4::config::v1::MatchField::LPM: {
+                auto prefixLen = producePrefixLength(bitwidth, policy);
+                protoMatch->mutable_lpm()->set_value(
+                    produceBytes(bitwidth, anchorField.first & prefixMask(bitwidth, prefixLen)));
+                protoMatch->mutable_lpm()->set_prefix_len(prefixLen);
+                break;
+            }
+            // Ternaries overlap if they agree on the bits both of them care about. Only flip the
+            // bits the anchor does not care about.
+            case p4::config::v1::MatchField::TERNARY: {
+                auto mask = Utils::getRandConstantForWidth(bitwidth)->value;
+                auto noise = Utils::getRandConstantForWidth(bitwidth)->value &
+                             (fullMask(bitwidth) ^ anchorField.second);
+                protoMatch->mutable_ternary()->set_value(
+                    produceBytes(bitwidth, (anchorField.first ^ noise) & mask));
+                protoMatch->mutable_ternary()->set_mask(produceBytes(bitwidth, mask));
+                break;
+            }
+            // Ranges overlap if the lower bound of one lies within the other.
+            case p4::config::v1::MatchField::RANGE: {
+                auto low = Utils::getRandBigInt(anchorField.first, anchorField.second);
+                auto high = Utils::getRandBigInt(low, fullMask(bitwidth));
+                protoMatch->mutable_range()->set_low(produceBytes(bitwidth, low));
+                protoMatch->mutable_range()->set_high(produceBytes(bitwidth, high));
+                break;
+            }
+            default:
+                P4C_UNIMPLEMENTED("Match type %1% not supported for P4RuntimeFuzzer yet",
+                                  p4::config::v1::MatchField::MatchType_Name(
+                                      matchField.match_type()));
+        }
+    }
+    return protoEntry;
+}
+
+p4::v1::TableEntry P4RuntimeFuzzer::produceTableEntryForOverlapTarget(
+    const p4::config::v1::Table &table,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+    const TablePolicy &policy) {
+    const auto *overlapIndex = getOverlapIndex(table, policy);
+    if (overlapIndex == nullptr || overlapIndex->empty()) {
+        return produceTableEntry(table, actions, policy);
+    }
+    // Derive the new entry from an existing one while the table overlaps less than desired.
+    // Otherwise, a uniformly random entry is very unlikely to overlap with anything.
+    if (overlapIndex->averageOverlapDegree() < policy.overlapTarget.value()) {
+        return produceOverlappingTableEntry(table, actions, overlapIndex->sampleEntry(), policy);
+    }
+    return produceTableEntry(table, actions, policy);
+}
+
+std::string P4RuntimeFuzzer::computeEntryKey(const p4::v1::TableEntry &entry) {
+    return computeCanonicalKey(entry.match());
+}
+
+void P4RuntimeFuzzer::produceUpdates(bool isInitialConfig,
+                                     WriteRequestBatcher<p4::v1::WriteRequest> &batcher,
+                                     uint64_t maxUpdatesPerTable, bool insertOnly) {
     const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
 
+    produceActionProfileUpdates(isInitialConfig, batcher);
+
     const auto tables = p4Info->tables();
     const auto actions = p4Info->actions();
 
-    auto tableCnt = tables.size();
-    auto request = std::make_unique<p4::v1::WriteRequest>();
-    for (auto tableId = 0; tableId < tableCnt; tableId++) {
+    for (auto tableId : selectTables()) {
         const auto &table = tables.Get(tableId);
-        // NOTE: Temporary use a coin to decide if generating entries for the table.
-        // Make this configurable.
-        if (table.match_fields_size() == 0 || table.is_const_table() ||
-            Utils::getRandInt(0, 4) == 0) {
-            continue;
+        const auto &policy = getTablePolicy(tableId);
+        // Entries of tables with an action profile need a member to refer to.
+        if (table.implementation_id() != 0) {
+            const auto &profile = findActionProfile(*p4Info, table.implementation_id());
+            if (!usesOneShotProgramming(profile) &&
+                actionProfileMembers[profile.preamble().name()].empty()) {
+                continue;
+            }
         }
 
-        auto maxEntryGenCnt = getProgramInfo().getFuzzerConfig().getMaxEntryGenCnt();
-        int attempts = 0;
-        // Try to keep track of the entries we have generated so far.
-        int count = 0;
-        // Retrieve the current table configuration.
-        auto &currentTableConfiguration = currentState[table.preamble().name()];
-        while (count < maxEntryGenCnt) {
-            if (attempts > getProgramInfo().getFuzzerConfig().getMaxAttempts()) {
-                warning("Failed to generate %d entries for table %s", maxEntryGenCnt,
-                        table.preamble().name());
+        auto *overlapIndex = getOverlapIndex(table, policy);
+        produceTableEntryUpdates(
+            table, policy, currentState[table.preamble().name()],
+            deletedEntries[table.preamble().name()],
+            isInitialConfig, insertOnly, maxUpdatesPerTable, batcher,
+            [&]() { return produceTableEntryForOverlapTarget(table, actions, policy); },
+            computeEntryKey,
+            [&](UpdateOperation operation, const std::string &entryKey,
+                p4::v1::TableEntry &entry) {
+                p4::v1::Update update;
+                switch (operation) {
+                    case UpdateOperation::Insert:
+                        update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+                        if (overlapIndex != nullptr) {
+                            overlapIndex->insert(entryKey, computeEntryRegion(table, entry));
+                        }
+                        break;
+                    case UpdateOperation::Modify:
+                        // Keep the match fields and the priority, only replace the action.
+                        *entry.mutable_action() = produceEntryAction(table, actions);
+                        update.set_type(p4::v1::Update_Type::Update_Type_MODIFY);
+                        break;
+                    case UpdateOperation::Delete:
+                        update.set_type(p4::v1::Update_Type::Update_Type_DELETE);
+                        if (overlapIndex != nullptr) {
+                            overlapIndex->erase(entryKey);
+                        }
+                        break;
+                }
+                *update.mutable_entity()->mutable_table_entry() = entry;
+                return update;
+            });
+    }
+}
+
+namespace {
+
+/// The largest committed rate of a generated byte or packet meter.
+constexpr int64_t MAX_BYTE_METER_RATE = 1250000000;
+constexpr int64_t MAX_PACKET_METER_RATE = 10000000;
+/// The largest committed burst of a generated byte or packet meter.
+constexpr int64_t MAX_BYTE_METER_BURST = 1000000;
+constexpr int64_t MAX_PACKET_METER_BURST = 10000;
+
+}  // namespace
+
+p4::v1::MeterConfig P4RuntimeFuzzer::produceMeterConfig(const p4::config::v1::MeterSpec &spec) {
+    bool isPacketMeter = spec.unit() == p4::config::v1::MeterSpec::PACKETS;
+    auto maxRate = isPacketMeter ? MAX_PACKET_METER_RATE : MAX_BYTE_METER_RATE;
+    auto maxBurst = isPacketMeter ? MAX_PACKET_METER_BURST : MAX_BYTE_METER_BURST;
+    p4::v1::MeterConfig protoConfig;
+    protoConfig.set_cir(Utils::getRandInt(1, maxRate));
+    protoConfig.set_cburst(Utils::getRandInt(1, maxBurst));
+    protoConfig.set_pir(Utils::getRandInt(protoConfig.cir(), 2 * maxRate));
+    protoConfig.set_pburst(Utils::getRandInt(protoConfig.cburst(), 2 * maxBurst));
+    return protoConfig;
+}
+
+std::optional<p4::v1::P4Data> P4RuntimeFuzzer::produceRegisterData(
+    const p4::config::v1::P4DataTypeSpec &typeSpec) {
+    if (!typeSpec.has_bitstring()) {
+        return std::nullopt;
+    }
+    const auto &bitstring = typeSpec.bitstring();
+    int bitwidth = 0;
+    if (bitstring.has_bit()) {
+        bitwidth = bitstring.bit().bitwidth();
+    } else if (bitstring.has_int_()) {
+        bitwidth = bitstring.int_().bitwidth();
+    } else {
+        return std::nullopt;
+    }
+    p4::v1::P4Data protoData;
+    protoData.set_bitstring(produceBytes(bitwidth));
+    return protoData;
+}
+
+void P4RuntimeFuzzer::produceResourceUpdates(bool isInitialConfig,
+                                             WriteRequestBatcher<p4::v1::WriteRequest> &batcher) {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    auto maxEntryGenCnt =
+        static_cast<size_t>(getProgramInfo().getFuzzerConfig().getMaxEntryGenCnt());
+    // Direct resources refer to table entries, which must be installed first.
+    batcher.flush();
+
+    // @returns the indices of the cells of a resource with @param size cells to write in this
+    // step. The initial configuration writes distinct cells, updates use a coin to decide whether
+    // to write a single cell.
+    auto produceIndices = [isInitialConfig, maxEntryGenCnt](int64_t size) {
+        std::vector<int64_t> indices;
+        if (size <= 0) {
+            return indices;
+        }
+        if (isInitialConfig) {
+            auto numIds = static_cast<size_t>(size);
+            for (auto id : sampleDistinctIds(std::min(maxEntryGenCnt, numIds), numIds)) {
+                indices.push_back(static_cast<int64_t>(id) - 1);
+            }
+        } else if (Utils::getRandInt(0, 1) == 1) {
+            indices.push_back(Utils::getRandInt(0, size - 1));
+        }
+        return indices;
+    };
+    // @returns the installed entries of @param tableId whose direct resources are written in this
+    // step.
+    auto produceDirectEntries = [this, p4Info, isInitialConfig, maxEntryGenCnt](uint32_t tableId) {
+        std::vector<const p4::v1::TableEntry *> entries;
+        const auto *table = P4::ControlPlaneAPI::findP4InfoObject(
+            p4Info->tables().begin(), p4Info->tables().end(), tableId);
+        if (table == nullptr) {
+            return entries;
+        }
+        auto it = currentState.find(table->preamble().name());
+        if (it == currentState.end() || it->second.empty()) {
+            return entries;
+        }
+        const auto &tableState = it->second;
+        if (isInitialConfig) {
+            for (auto id : sampleDistinctIds(std::min(maxEntryGenCnt, tableState.size()),
+                                             tableState.size())) {
+                entries.push_back(&tableState.entryAt(id - 1));
+            }
+        } else if (Utils::getRandInt(0, 1) == 1) {
+            entries.push_back(&tableState.entryAt(tableState.samplePosition()));
+        }
+        return entries;
+    };
+    // An entry is identified by its table, its match fields, and its priority.
+    auto copyEntryKey = [](const p4::v1::TableEntry &entry, p4::v1::TableEntry &protoEntry) {
+        protoEntry.set_table_id(entry.table_id());
+        *protoEntry.mutable_match() = entry.match();
+        protoEntry.set_priority(entry.priority());
+    };
+    // Indexed and direct resources always exist, so they can only be modified.
+    auto addModify = [&batcher](p4::v1::Update &&update) {
+        update.set_type(p4::v1::Update_Type::Update_Type_MODIFY);
+        batcher.add(std::move(update));
+    };
+
+    for (const auto &meter : p4Info->meters()) {
+        for (auto index : produceIndices(meter.size())) {
+            p4::v1::Update update;
+            auto *protoEntry = update.mutable_entity()->mutable_meter_entry();
+            protoEntry->set_meter_id(meter.preamble().id());
+            protoEntry->mutable_index()->set_index(index);
+            *protoEntry->mutable_config() = produceMeterConfig(meter.spec());
+            addModify(std::move(update));
+        }
+    }
+    for (const auto &meter : p4Info->direct_meters()) {
+        for (const auto *entry : produceDirectEntries(meter.direct_table_id())) {
+            p4::v1::Update update;
+            auto *protoEntry = update.mutable_entity()->mutable_direct_meter_entry();
+            copyEntryKey(*entry, *protoEntry->mutable_table_entry());
+            *protoEntry->mutable_config() = produceMeterConfig(meter.spec());
+            addModify(std::move(update));
+        }
+    }
+    for (const auto &counter : p4Info->counters()) {
+        for (auto index : produceIndices(counter.size())) {
+            p4::v1::Update update;
+            auto *protoEntry = update.mutable_entity()->mutable_counter_entry();
+            protoEntry->set_counter_id(counter.preamble().id());
+            protoEntry->mutable_index()->set_index(index);
+            // Writing counter data of 0 resets the counter.
+            protoEntry->mutable_data();
+            addModify(std::move(update));
+        }
+    }
+    for (const auto &counter : p4Info->direct_counters()) {
+        for (const auto *entry : produceDirectEntries(counter.direct_table_id())) {
+            p4::v1::Update update;
+            auto *protoEntry = update.mutable_entity()->mutable_direct_counter_entry();
+            copyEntryKey(*entry, *protoEntry->mutable_table_entry());
+            protoEntry->mutable_data();
+            addModify(std::move(update));
+        }
+    }
+    for (const auto &reg : p4Info->registers()) {
+        for (auto index : produceIndices(reg.size())) {
+            auto data = produceRegisterData(reg.type_spec());
+            if (!data.has_value()) {
                 break;
             }
-            auto entry = produceTableEntry(table, actions);
-            // TODO: This is inefficient, but currently works.
-            std::stringstream matchFieldStream;
-            for (const auto &match : entry.match()) {
-                matchFieldStream << match.DebugString();
-            }
-            auto matchFieldString = matchFieldStream.str();
-            // Only insert unique entries that actually insert.
-            if (currentTableConfiguration.find(matchFieldString) ==
-                currentTableConfiguration.end()) {
-                auto *update = request->add_updates();
-                update->set_type(p4::v1::Update_Type::Update_Type_INSERT);
-                update->mutable_entity()->mutable_table_entry()->CopyFrom(entry);
-                count++;
-                currentTableConfiguration.insert(matchFieldString);
-            } else if (!isInitialConfig) {
-                // In case of an initial config we may update or delete entries.
-                auto *update = request->add_updates();
-                // Whether we update or delete the entry is determined randomly.
-                auto thresholdForDeletion =
-                    getProgramInfo().getFuzzerConfig().getThresholdForDeletion();
-                auto updateOrNot = Utils::getRandInt(100) >= thresholdForDeletion;
-                if (updateOrNot) {
-                    update->set_type(p4::v1::Update_Type::Update_Type_MODIFY);
-                } else {
-                    update->set_type(p4::v1::Update_Type::Update_Type_DELETE);
-                    currentTableConfiguration.erase(matchFieldString);
+            p4::v1::Update update;
+            auto *protoEntry = update.mutable_entity()->mutable_register_entry();
+            protoEntry->set_register_id(reg.preamble().id());
+            protoEntry->mutable_index()->set_index(index);
+            *protoEntry->mutable_data() = std::move(data.value());
+            addModify(std::move(update));
+        }
+    }
+}
+
+std::unique_ptr<p4::v1::ReadRequest> P4RuntimeFuzzer::produceReadRequest() {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+
+    // Collect the kinds of reads that are possible for the current state.
+    enum class ReadKind { Table, TableEntry, Counter, DirectCounter, Register, Meter };
+    std::vector<const TableState<p4::v1::TableEntry> *> installedTables;
+    for (const auto &[tableName, tableState] : currentState) {
+        if (!tableState.empty()) {
+            installedTables.push_back(&tableState);
+        }
+    }
+    std::vector<ReadKind> readKinds;
+    if (p4Info->tables_size() > 0) {
+        readKinds.push_back(ReadKind::Table);
+    }
+    if (!installedTables.empty()) {
+        readKinds.push_back(ReadKind::TableEntry);
+    }
+    if (p4Info->counters_size() > 0) {
+        readKinds.push_back(ReadKind::Counter);
+    }
+    if (p4Info->direct_counters_size() > 0) {
+        readKinds.push_back(ReadKind::DirectCounter);
+    }
+    if (p4Info->registers_size() > 0) {
+        readKinds.push_back(ReadKind::Register);
+    }
+    if (p4Info->meters_size() > 0) {
+        readKinds.push_back(ReadKind::Meter);
+    }
+    if (readKinds.empty()) {
+        return nullptr;
+    }
+
+    // Indexed resources are read either entirely or at a single random index.
+    auto produceIndex = [](int64_t size, auto &protoEntry) {
+        if (size > 0 && Utils::getRandInt(0, 1) == 0) {
+            protoEntry.mutable_index()->set_index(Utils::getRandInt(0, size - 1));
+        }
+    };
+
+    auto request = std::make_unique<p4::v1::ReadRequest>();
+    auto *entity = request->add_entities();
+    switch (readKinds.at(Utils::getRandInt(readKinds.size() - 1))) {
+        case ReadKind::Table: {
+            const auto &table = p4Info->tables(Utils::getRandInt(p4Info->tables_size() - 1));
+            entity->mutable_table_entry()->set_table_id(table.preamble().id());
+            break;
+        }
+        case ReadKind::TableEntry: {
+            const auto &tableState =
+                *installedTables.at(Utils::getRandInt(installedTables.size() - 1));
+            const auto &entry = tableState.entryAt(tableState.samplePosition());
+            // An entry is identified by its table, its match fields, and its priority.
+            auto *protoEntry = entity->mutable_table_entry();
+            protoEntry->set_table_id(entry.table_id());
+            *protoEntry->mutable_match() = entry.match();
+            protoEntry->set_priority(entry.priority());
+            break;
+        }
+        case ReadKind::Counter: {
+            const auto &counter =
+                p4Info->counters(Utils::getRandInt(p4Info->counters_size() - 1));
+            auto *protoEntry = entity->mutable_counter_entry();
+            protoEntry->set_counter_id(counter.preamble().id());
+            produceIndex(counter.size(), *protoEntry);
+            break;
+        }
+        case ReadKind::DirectCounter: {
+            const auto &counter =
+                p4Info->direct_counters(Utils::getRandInt(p4Info->direct_counters_size() - 1));
+            auto *protoEntry = entity->mutable_direct_counter_entry()->mutable_table_entry();
+            protoEntry->set_table_id(counter.direct_table_id());
+            // Read the counter of a single installed entry or the counters of the whole table.
+            const auto *table = P4::ControlPlaneAPI::findP4InfoObject(
+                p4Info->tables().begin(), p4Info->tables().end(), counter.direct_table_id());
+            if (table != nullptr && Utils::getRandInt(0, 1) == 0) {
+                auto it = currentState.find(table->preamble().name());
+                if (it != currentState.end() && !it->second.empty()) {
+                    const auto &entry = it->second.entryAt(it->second.samplePosition());
+                    *protoEntry->mutable_match() = entry.match();
+                    protoEntry->set_priority(entry.priority());
                 }
-                update->mutable_entity()->mutable_table_entry()->CopyFrom(entry);
-                count++;
             }
-            attempts++;
+            break;
+        }
+        case ReadKind::Register: {
+            const auto &reg = p4Info->registers(Utils::getRandInt(p4Info->registers_size() - 1));
+            auto *protoEntry = entity->mutable_register_entry();
+            protoEntry->set_register_id(reg.preamble().id());
+            produceIndex(reg.size(), *protoEntry);
+            break;
+        }
+        case ReadKind::Meter: {
+            const auto &meter = p4Info->meters(Utils::getRandInt(p4Info->meters_size() - 1));
+            auto *protoEntry = entity->mutable_meter_entry();
+            protoEntry->set_meter_id(meter.preamble().id());
+            produceIndex(meter.size(), *protoEntry);
+            break;
+        }
+    }
+    return request;
+}
+
+ProtobufMessagePtr P4RuntimeFuzzer::produceEmptyWriteRequest() const {
+    return std::make_unique<p4::v1::WriteRequest>();
+}
+
+ProtobufMessagePtr P4RuntimeFuzzer::produceEmptyReadResponse() const {
+    return std::make_unique<p4::v1::ReadResponse>();
+}
+
+ProtobufMessagePtr P4RuntimeFuzzer::produceStateSnapshot() const {
+    auto request = std::make_unique<p4::v1::WriteRequest>();
+    auto addInsertion = [&request]() {
+        auto *update = request->add_updates();
+        update->set_type(p4::v1::Update_Type::Update_Type_INSERT);
+        return update->mutable_entity();
+    };
+    // Members first and groups second, so that table entries can refer to them. The order of the
+    // members and groups of a profile is preserved, so that a restored fuzzer samples the same
+    // members and groups.
+    for (const auto &[profileName, members] : actionProfileMembers) {
+        for (size_t position = 0; position < members.size(); ++position) {
+            *addInsertion()->mutable_action_profile_member() = members.entryAt(position);
+        }
+    }
+    for (const auto &[profileName, groups] : actionProfileGroups) {
+        for (size_t position = 0; position < groups.size(); ++position) {
+            *addInsertion()->mutable_action_profile_group() = groups.entryAt(position);
+        }
+    }
+    for (const auto &[tableName, tableState] : currentState) {
+        for (size_t position = 0; position < tableState.size(); ++position) {
+            *addInsertion()->mutable_table_entry() = tableState.entryAt(position);
         }
     }
     return request;
 }
 
+bool P4RuntimeFuzzer::applyWriteRequest(const google::protobuf::Message &request) {
+    const auto *writeRequest = dynamic_cast<const p4::v1::WriteRequest *>(&request);
+    if (writeRequest == nullptr) {
+        error("P4RuntimeSmith: Expected a P4Runtime write request, got a %1%.",
+              request.GetDescriptor()->full_name());
+        return false;
+    }
+    for (const auto &update : writeRequest->updates()) {
+        if (!applyUpdate(update)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool P4RuntimeFuzzer::applyReadResponse(google::protobuf::Message &response) {
+    auto *readResponse = dynamic_cast<p4::v1::ReadResponse *>(&response);
+    if (readResponse == nullptr) {
+        error("P4RuntimeSmith: Expected a P4Runtime read response, got a %1%.",
+              response.GetDescriptor()->full_name());
+        return false;
+    }
+    // Swap every entity into the same insertion instead of copying it.
+    p4::v1::Update update;
+    update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+    for (auto &entity : *readResponse->mutable_entities()) {
+        update.mutable_entity()->Swap(&entity);
+        if (!applyUpdate(update)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool P4RuntimeFuzzer::applyUpdate(const p4::v1::Update &update) {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    const auto &entity = update.entity();
+    auto isDelete = update.type() == p4::v1::Update_Type::Update_Type_DELETE;
+    // Insert an object or replace the installed one with the same key, keeping its position.
+    auto apply = [isDelete](auto &state, const std::string &key, const auto &object) {
+        if (isDelete) {
+            state.erase(key);
+        } else if (auto *installed = state.find(key)) {
+            *installed = object;
+        } else {
+            state.insert(key, object);
+        }
+    };
+    switch (entity.entity_case()) {
+        case p4::v1::Entity::kTableEntry: {
+            const auto &entry = entity.table_entry();
+            const auto &tables = p4Info->tables();
+            // The policy of the table is indexed by the position of the table.
+            auto tableIt = std::find_if(tables.begin(), tables.end(), [&entry](const auto &table) {
+                return table.preamble().id() == entry.table_id();
+            });
+            if (tableIt == tables.end()) {
+                error("P4RuntimeSmith: Unknown table id %1%.", entry.table_id());
+                return false;
+            }
+            const auto *table = &*tableIt;
+            const auto &policy = getTablePolicy(static_cast<int>(tableIt - tables.begin()));
+            auto &tableState = currentState[table->preamble().name()];
+            auto entryKey = computeEntryKey(entry);
+            // Keep programming action selectors the way the entries were programmed.
+            const p4::config::v1::ActionProfile *profile = nullptr;
+            if (!isDelete && table->implementation_id() != 0) {
+                profile = P4::ControlPlaneAPI::findP4InfoObject(p4Info->action_profiles().begin(),
+                                                                p4Info->action_profiles().end(),
+                                                                table->implementation_id());
+                if (profile == nullptr) {
+                    error("P4RuntimeSmith: Unknown action profile id %1%.",
+                          table->implementation_id());
+                    return false;
+                }
+            }
+            if (auto *overlapIndex = getOverlapIndex(*table, policy)) {
+                if (isDelete) {
+                    overlapIndex->erase(entryKey);
+                } else if (!tableState.contains(entryKey)) {
+                    overlapIndex->insert(entryKey, computeEntryRegion(*table, entry));
+                }
+            }
+            apply(tableState, entryKey, entry);
+            if (profile != nullptr && profile->with_selector()) {
+                oneShotSelectors[profile->preamble().name()] =
+                    entry.action().has_action_profile_action_set();
+            }
+            return true;
+        }
+        case p4::v1::Entity::kActionProfileMember: {
+            const auto &member = entity.action_profile_member();
+            const auto *profile = P4::ControlPlaneAPI::findP4InfoObject(
+                p4Info->action_profiles().begin(), p4Info->action_profiles().end(),
+                member.action_profile_id());
+            if (profile == nullptr) {
+                error("P4RuntimeSmith: Unknown action profile id %1%.", member.action_profile_id());
+                return false;
+            }
+            oneShotSelectors[profile->preamble().name()] = false;
+            apply(actionProfileMembers[profile->preamble().name()],
+                  std::to_string(member.member_id()), member);
+            // Ids are not reused, so the next id follows the largest id seen so far.
+            auto &nextMemberId =
+                nextMemberIds.try_emplace(profile->preamble().name(), 1).first->second;
+            nextMemberId = std::max(nextMemberId, member.member_id() + 1);
+            return true;
+        }
+        case p4::v1::Entity::kActionProfileGroup: {
+            const auto &group = entity.action_profile_group();
+            const auto *profile = P4::ControlPlaneAPI::findP4InfoObject(
+                p4Info->action_profiles().begin(), p4Info->action_profiles().end(),
+                group.action_profile_id());
+            if (profile == nullptr) {
+                error("P4RuntimeSmith: Unknown action profile id %1%.", group.action_profile_id());
+                return false;
+            }
+            apply(actionProfileGroups[profile->preamble().name()], std::to_string(group.group_id()),
+                  group);
+            auto &nextGroupId =
+                nextGroupIds.try_emplace(profile->preamble().name(), 1).first->second;
+            nextGroupId = std::max(nextGroupId, group.group_id() + 1);
+            return true;
+        }
+        default:
+            // Meters, counters, and registers are not part of the state of the fuzzer.
+            return true;
+    }
+}
+
 /// Some Helper functions below
 
+namespace {
+
+/// @returns the generation policies of the P4Info tables of @param programInfo, in table order.
+std::vector<TablePolicy> resolveTablePolicies(const ProgramInfo &programInfo) {
+    const auto &tables = programInfo.getP4RuntimeApi().p4Info->tables();
+    std::vector<TablePolicy> tablePolicies(tables.size());
+    // Policies refer to tables by their fully qualified name or by their alias.
+    for (const auto &[tableName, policy] : programInfo.getFuzzerConfig().getTablePolicies()) {
+        auto it = std::find_if(tables.begin(), tables.end(), [&tableName](const auto &table) {
+            return table.preamble().name() == tableName || table.preamble().alias() == tableName;
+        });
+        if (it == tables.end()) {
+            warning("P4RuntimeSmith: The program does not contain the table %1% of a table policy.",
+                    tableName);
+            continue;
+        }
+        tablePolicies.at(it - tables.begin()) = policy;
+    }
+    return tablePolicies;
+}
+
+/// @returns the selection weight of @param table with @param policy under @param weighting.
+double computeTableWeight(const p4::config::v1::Table &table, const TablePolicy &policy,
+                          TableWeighting weighting) {
+    // Disabled and constant tables and tables without key fields are never selected.
+    if (!policy.enabled || table.match_fields_size() == 0 || table.is_const_table()) {
+        return 0;
+    }
+    if (policy.weight.has_value()) {
+        return policy.weight.value();
+    }
+    switch (weighting) {
+        case TableWeighting::Size:
+            return static_cast<double>(std::max<int64_t>(table.size(), 1));
+        case TableWeighting::KeyWidth: {
+            int keyWidth = 0;
+            for (const auto &matchField : table.match_fields()) {
+                keyWidth += matchField.bitwidth();
+            }
+            return std::max(keyWidth, 1);
+        }
+        case TableWeighting::Uniform:
+        default:
+            return 1;
+    }
+}
+
+/// @returns a selector of the P4Info tables of @param programInfo with @param tablePolicies.
+TableSelector produceTableSelector(const ProgramInfo &programInfo,
+                                   const std::vector<TablePolicy> &tablePolicies) {
+    const auto &fuzzerConfig = programInfo.getFuzzerConfig();
+    const auto &tables = programInfo.getP4RuntimeApi().p4Info->tables();
+    std::vector<TableSelector::Candidate> candidates;
+    for (int tableIndex = 0; tableIndex < tables.size(); tableIndex++) {
+        const auto &table = tables.Get(tableIndex);
+        candidates.push_back({{table.preamble().name(), table.preamble().alias()},
+                              computeTableWeight(table, tablePolicies.at(tableIndex),
+                                                 fuzzerConfig.getTableWeighting())});
+    }
+    return {candidates, fuzzerConfig.getTablesToSkip(),
+            static_cast<size_t>(fuzzerConfig.getMaxTables())};
+}
+
+}  // namespace
+
+RuntimeFuzzer::RuntimeFuzzer(const ProgramInfo &programInfo)
+    : programInfo(programInfo),
+      tablePolicies(resolveTablePolicies(programInfo)),
+      tableSelector(produceTableSelector(programInfo, tablePolicies)) {}
+
+const TablePolicy &RuntimeFuzzer::getTablePolicy(int tableIndex) const {
+    return tablePolicies.at(tableIndex);
+}
+
+std::vector<int> RuntimeFuzzer::selectTables() const { return tableSelector.select(); }
+
+std::optional<size_t> RuntimeFuzzer::getTableCapacity(const p4::config::v1::Table &table,
+                                                      const TablePolicy &policy) {
+    if (table.size() <= 0) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(static_cast<double>(table.size()) * policy.fillRatio);
+}
+
+int RuntimeFuzzer::producePrefixLength(int bitwidth, const TablePolicy &policy) {
+    auto maxPrefixLength = std::min(policy.maxPrefixLength.value_or(bitwidth), bitwidth);
+    auto minPrefixLength = std::min(policy.minPrefixLength, maxPrefixLength);
+    return static_cast<int>(Utils::getRandInt(minPrefixLength, maxPrefixLength));
+}
+
+bool RuntimeFuzzer::produceWildcard(const TablePolicy &policy) {
+    // Only draw from the random number generator if wildcards are enabled.
+    return policy.wildcardProbability > 0 && getRandUnit() < policy.wildcardProbability;
+}
+
+RuntimeFuzzer::UpdateOperation RuntimeFuzzer::pickUpdateOperation(bool hasInstalledEntries) const {
+    return pickUpdateOperation(hasInstalledEntries, TablePolicy());
+}
+
+RuntimeFuzzer::UpdateOperation RuntimeFuzzer::pickUpdateOperation(bool hasInstalledEntries,
+                                                                  const TablePolicy &policy,
+                                                                  bool canInsert) const {
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    auto insertWeight =
+        canInsert ? policy.insertWeight.value_or(fuzzerConfig.getInsertWeight()) : 0;
+    auto modifyWeight = policy.modifyWeight.value_or(fuzzerConfig.getModifyWeight());
+    auto deleteWeight = policy.deleteWeight.value_or(fuzzerConfig.getDeleteWeight());
+    if (!hasInstalledEntries || modifyWeight + deleteWeight == 0) {
+        return UpdateOperation::Insert;
+    }
+    auto roll = Utils::getRandInt(insertWeight + modifyWeight + deleteWeight - 1);
+    if (roll < insertWeight) {
+        return UpdateOperation::Insert;
+    }
+    if (roll < insertWeight + modifyWeight) {
+        return UpdateOperation::Modify;
+    }
+    return UpdateOperation::Delete;
+}
+
+std::vector<WorkloadPhase> RuntimeFuzzer::getWorkloadPhases() const {
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    if (!fuzzerConfig.getWorkloadPhases().empty()) {
+        return fuzzerConfig.getWorkloadPhases();
+    }
+    return {{Utils::getRandInt(fuzzerConfig.getMaxUpdateCount()),
+             ArrivalProcess::uniform(fuzzerConfig.getMinUpdateTimeInMicroseconds(),
+                                     fuzzerConfig.getMaxUpdateTimeInMicroseconds()),
+             StepSize::fixed(fuzzerConfig.getMaxEntryGenCnt()), false}};
+}
+
+size_t RuntimeFuzzer::produceReadCount() const {
+    auto readRatio = getProgramInfo().getFuzzerConfig().getReadRatio();
+    auto readCount = static_cast<size_t>(readRatio);
+    // Round the fractional part up with the matching probability, so that the expected number of
+    // reads per time step equals the read ratio.
+    static constexpr uint64_t RESOLUTION = 1000000;
+    auto fraction =
+        static_cast<uint64_t>((readRatio - static_cast<double>(readCount)) * RESOLUTION);
+    // Only draw from the random number generator if there is a fractional part to round.
+    if (fraction > 0 && Utils::getRandInt(RESOLUTION - 1) < fraction) {
+        readCount++;
+    }
+    return readCount;
+}
+
+const WorkloadPhase *RuntimeFuzzer::nextWorkloadStep(size_t &stepInPhase) {
+    if (!workloadPhases.has_value()) {
+        workloadPhases = getWorkloadPhases();
+        if (checkpoint != nullptr) {
+            restoreSeriesLength(workloadPhases.value());
+            // Skip the completed time steps without drawing from the random number generator.
+            for (uint64_t skipped = 0; skipped < checkpoint->getPosition().steps; ++skipped) {
+                if (nextWorkloadStep(stepInPhase) == nullptr) {
+                    break;
+                }
+            }
+        }
+    }
+    const auto &phases = workloadPhases.value();
+    while (currentPhase < phases.size() && currentPhaseStep >= phases[currentPhase].numSteps) {
+        currentPhase++;
+        currentPhaseStep = 0;
+    }
+    if (currentPhase >= phases.size()) {
+        return nullptr;
+    }
+    stepInPhase = currentPhaseStep++;
+    return &phases[currentPhase];
+}
+
+bool RuntimeFuzzer::completeStep(uint64_t numRequests) {
+    if (checkpoint == nullptr || !checkpoint->completeStep(numRequests)) {
+        return true;
+    }
+    return checkpoint->startEpoch(*produceStateSnapshot());
+}
+
+bool RuntimeFuzzer::completePulledStep() {
+    if (!uncompletedStepRequests.has_value()) {
+        return true;
+    }
+    return completeStep(std::exchange(uncompletedStepRequests, std::nullopt).value());
+}
+
+UpdateSeries RuntimeFuzzer::produceUpdateTimeSeries() {
+    UpdateSeries updateSeries;
+    // Requests of a time step that were only partially pulled come first.
+    for (auto &update : pendingUpdates) {
+        updateSeries.push_back(std::move(update));
+    }
+    pendingUpdates.clear();
+    if (!completePulledStep()) {
+        return updateSeries;
+    }
+    for (auto &update : produceUpdateSteps(std::numeric_limits<size_t>::max())) {
+        updateSeries.push_back(std::move(update));
+    }
+    return updateSeries;
+}
+
+std::optional<TimedUpdate> RuntimeFuzzer::nextUpdate() {
+    if (pendingUpdates.empty()) {
+        // All requests of the previous time step have been pulled.
+        if (!completePulledStep()) {
+            return std::nullopt;
+        }
+        // Every time step contains at least one request, so one step suffices.
+        deferStepCompletion = true;
+        auto updateSeries = produceUpdateSteps(1);
+        deferStepCompletion = false;
+        for (auto &update : updateSeries) {
+            pendingUpdates.push_back(std::move(update));
+        }
+        if (pendingUpdates.empty()) {
+            return std::nullopt;
+        }
+    }
+    auto update = std::move(pendingUpdates.front());
+    pendingUpdates.pop_front();
+    return update;
+}
+
+size_t RuntimeFuzzer::forEachUpdate(const UpdateConsumer &consume) {
+    size_t numUpdates = 0;
+    while (auto update = nextUpdate()) {
+        numUpdates++;
+        if (!consume(update->first, std::move(update->second))) {
+            break;
+        }
+    }
+    return numUpdates;
+}
+
+void RuntimeFuzzer::restoreSeriesLength(std::vector<WorkloadPhase> &phases) const {
+    const auto &position = checkpoint->getPosition();
+    if (position.totalSteps == 0) {
+        uint64_t totalSteps = 0;
+        for (const auto &phase : phases) {
+            totalSteps += phase.numSteps;
+        }
+        checkpoint->setTotalSteps(totalSteps);
+        return;
+    }
+    // Only the length of the default phase is random, configured phases have a fixed length.
+    if (getProgramInfo().getFuzzerConfig().getWorkloadPhases().empty()) {
+        phases.front().numSteps = position.totalSteps;
+    }
+}
+
+bool RuntimeFuzzer::loadInitialState(const std::filesystem::path &path) {
+    auto writeRequest = produceEmptyWriteRequest();
+    auto readResponse = produceEmptyReadResponse();
+    auto index =
+        Protobuf::parseAnyMessageFromFile(path, {writeRequest.get(), readResponse.get()});
+    if (!index.has_value()) {
+        return false;
+    }
+    return index.value() == 0 ? applyWriteRequest(*writeRequest)
+                              : applyReadResponse(*readResponse);
+}
+
+bool RuntimeFuzzer::restoreFromCheckpoint() {
+    BUG_CHECK(checkpoint != nullptr, "No checkpoint to restore from.");
+    std::vector<ProtobufMessagePtr> requests;
+    if (!checkpoint->load(*produceEmptyWriteRequest(), requests)) {
+        return false;
+    }
+    for (const auto &request : requests) {
+        if (!applyWriteRequest(*request)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::string RuntimeFuzzer::checkBigIntToString(const big_int &value, int bitwidth) {
     std::optional<std::string> valueStr = P4::ControlPlaneAPI::stringReprConstant(value, bitwidth);
     BUG_CHECK(valueStr.has_value(), "Failed to check %1% to string, maybe value < 0?", value.str());
@@ -241,4 +1341,53 @@ bool RuntimeFuzzer::tableHasFieldType(const p4::config::v1::Table &table,
     return false;
 }
 
+const p4::config::v1::Table *RuntimeFuzzer::findActionProfileTable(
+    const p4::config::v1::P4Info &p4Info, uint32_t profileId) {
+    for (const auto &table : p4Info.tables()) {
+        if (table.implementation_id() == profileId) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
+
+const p4::config::v1::ActionProfile &RuntimeFuzzer::findActionProfile(
+    const p4::config::v1::P4Info &p4Info, uint32_t profileId) {
+    const auto *profile = P4::ControlPlaneAPI::findP4InfoObject(
+        p4Info.action_profiles().begin(), p4Info.action_profiles().end(), profileId);
+    BUG_CHECK(profile != nullptr, "Action profile %1% not found.", profileId);
+    return *profile;
+}
+
+std::vector<uint32_t> RuntimeFuzzer::sampleDistinctIds(size_t count, size_t numIds) {
+    BUG_CHECK(count <= numIds, "Can not draw %1% distinct ids from %2% ids.", count, numIds);
+    // Partial Fisher-Yates shuffle of the ids.
+    std::vector<uint32_t> ids(numIds);
+    for (size_t idx = 0; idx < numIds; idx++) {
+        ids[idx] = idx + 1;
+    }
+    for (size_t idx = 0; idx < count; idx++) {
+        std::swap(ids[idx], ids[Utils::getRandInt(static_cast<int64_t>(idx),
+                                                  static_cast<int64_t>(numIds) - 1)]);
+    }
+    ids.resize(count);
+    return ids;
+}
+
+int RuntimeFuzzer::getMaxGroupSize(const p4::config::v1::ActionProfile &profile) const {
+    auto maxGroupSize = getProgramInfo().getFuzzerConfig().getMaxGroupSize();
+    if (profile.max_group_size() > 0) {
+        maxGroupSize = std::min(maxGroupSize, profile.max_group_size());
+    }
+    return maxGroupSize;
+}
+
+size_t RuntimeFuzzer::produceGroupSize(const p4::config::v1::ActionProfile &profile,
+                                       size_t numMembers) const {
+    auto upperBound = std::min<int64_t>(getMaxGroupSize(profile), numMembers);
+    auto lowerBound =
+        std::min<int64_t>(getProgramInfo().getFuzzerConfig().getMinGroupSize(), upperBound);
+    return Utils::getRandInt(lowerBound, upperBound);
+}
+
 }  // namespace P4::P4Tools::RtSmith
@@ -1,7 +1,23 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_FUZZER_H_
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_FUZZER_H_
 
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/modules/rtsmith/core/checkpoint.h"
+#include "backends/p4tools/modules/rtsmith/core/overlap_index.h"
 #include "backends/p4tools/modules/rtsmith/core/program_info.h"
+#include "backends/p4tools/modules/rtsmith/core/table_selector.h"
+#include "backends/p4tools/modules/rtsmith/core/table_state.h"
+#include "backends/p4tools/modules/rtsmith/core/write_request_batcher.h"
+#include "lib/error.h"
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -14,30 +30,397 @@ namespace P4::P4Tools::RtSmith {
 
 using ProtobufMessagePtr = std::unique_ptr<google::protobuf::Message>;
 using InitialConfig = std::vector<ProtobufMessagePtr>;
+/// Each element is the delay (in microseconds) before the update request is sent and the request.
+/// A time step whose updates do not fit into a single request becomes a burst: The delay of all
+/// requests after the first one of the step is 0. Read requests may be interleaved with the write
+/// requests; they follow the writes of their time step with a delay of 0.
 using UpdateSeries = std::vector<std::pair<uint64_t, ProtobufMessagePtr>>;
+/// A single request of an update series and the delay (in microseconds) before it is sent.
+using TimedUpdate = std::pair<uint64_t, ProtobufMessagePtr>;
+/// Receives the requests of an update series one at a time. Returns false to stop the series.
+using UpdateConsumer = std::function<bool(uint64_t microseconds, ProtobufMessagePtr request)>;
 
 class RuntimeFuzzer {
  private:
     /// The program info of the target.
     std::reference_wrapper<const ProgramInfo> programInfo;
 
+    /// The checkpoint the update series is recorded in, nullptr if checkpointing is disabled.
+    Checkpoint *checkpoint = nullptr;
+
+    /// The phases of the update series, fixed when the first time step is produced.
+    std::optional<std::vector<WorkloadPhase>> workloadPhases;
+
+    /// The phase of the next time step and the index of the time step within the phase.
+    size_t currentPhase = 0;
+    size_t currentPhaseStep = 0;
+
+    /// The requests of the current time step that have not been pulled by `nextUpdate` yet.
+    std::deque<TimedUpdate> pendingUpdates;
+
+    /// Whether the time step being produced is pulled by `nextUpdate`. Its completion is then
+    /// only recorded in the checkpoint once all of its requests have been pulled.
+    bool deferStepCompletion = false;
+
+    /// The number of requests of the time step pulled by `nextUpdate` whose completion has not
+    /// been recorded in the checkpoint yet.
+    std::optional<uint64_t> uncompletedStepRequests;
+
+    /// @brief Record the completion of a time step in the checkpoint, if any, and start a new
+    /// epoch every checkpoint interval.
+    /// @param numRequests The number of requests of the time step.
+    /// @return False if the checkpoint can not be written.
+    bool completeStep(uint64_t numRequests);
+
+    /// @brief Record the completion of the time step pulled by `nextUpdate`, if there is one.
+    /// Called once all of its requests have been pulled, before the next time step is produced.
+    /// @return False if the checkpoint can not be written.
+    bool completePulledStep();
+
+    /// The generation policies of the tables of the program, indexed like the tables of the
+    /// P4Info. Resolved once from the policies of the fuzzer configuration.
+    std::vector<TablePolicy> tablePolicies;
+
+    /// Selects the tables whose entries are generated.
+    TableSelector tableSelector;
+
+    /// @brief Advance the update series by one time step. The first call fixes the phases and
+    /// skips the time steps that were completed before the checkpoint was taken.
+    /// @param stepInPhase Set to the index of the time step within its phase.
+    /// @return The phase of the time step or nullptr if the series has ended.
+    const WorkloadPhase *nextWorkloadStep(size_t &stepInPhase);
+
  protected:
     /// @returns the program info associated with the current target.
     [[nodiscard]] virtual const ProgramInfo &getProgramInfo() const { return programInfo; }
 
-    /// A map of control plane objects and their current state.
-    std::map<std::string, std::set<std::string>> currentState;
+    /// The kinds of operations an update may perform on a table.
+    enum class UpdateOperation { Insert, Modify, Delete };
+
+    /// @brief Pick the operation of the next update according to the configured update weights.
+    /// @param hasInstalledEntries whether the table has entries that can be modified or deleted.
+    /// @return The operation, always `Insert` if the table has no installed entries.
+    [[nodiscard]] UpdateOperation pickUpdateOperation(bool hasInstalledEntries) const;
+
+    /// @brief Pick the operation of the next update of a table. The update weights of @param
+    /// policy override the configured update weights. If @param canInsert is false, e.g., because
+    /// the table is full, only modifications and deletions are picked, unless there are none to
+    /// pick from.
+    [[nodiscard]] UpdateOperation pickUpdateOperation(bool hasInstalledEntries,
+                                                      const TablePolicy &policy,
+                                                      bool canInsert = true) const;
+
+    /// @returns the generation policy of the table at @param tableIndex in the P4Info.
+    [[nodiscard]] const TablePolicy &getTablePolicy(int tableIndex) const;
+
+    /// @returns the indices of the P4Info tables whose entries are generated next, in ascending
+    /// order. Skipped, disabled, and constant tables and tables without key fields are never
+    /// selected. At most `maxTables` tables are selected, weighted by the table weighting.
+    [[nodiscard]] std::vector<int> selectTables() const;
+
+    /// @returns the number of entries insertions fill @param table with at most, following the
+    /// fill ratio of @param policy, or std::nullopt if the table does not declare its size.
+    [[nodiscard]] static std::optional<size_t> getTableCapacity(const p4::config::v1::Table &table,
+                                                                const TablePolicy &policy);
+
+    /// @returns a prefix length for an LPM field of @param bitwidth bits, chosen uniformly from
+    /// the prefix length range of @param policy.
+    [[nodiscard]] static int producePrefixLength(int bitwidth, const TablePolicy &policy);
+
+    /// @returns true if a ternary field of a new entry is a wildcard, following @param policy.
+    [[nodiscard]] static bool produceWildcard(const TablePolicy &policy);
+
+    /// @brief Produce an `InitialConfig` from the updates `produceUpdates` adds to a batcher.
+    /// @param produceUpdates Called once with a `WriteRequestBatcher<RequestType>`.
+    /// @return The requests of the batcher.
+    template <typename RequestType, typename ProduceUpdates>
+    InitialConfig produceBatchedInitialConfig(ProduceUpdates &&produceUpdates) const {
+        const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+        WriteRequestBatcher<RequestType> batcher(fuzzerConfig.getMaxUpdatesPerRequest(),
+                                                 fuzzerConfig.getMaxBytesPerRequest());
+        produceUpdates(batcher);
+        batcher.flush();
+
+        InitialConfig initialConfig;
+        for (auto &request : batcher.takeRequests()) {
+            initialConfig.push_back(std::move(request));
+        }
+        return initialConfig;
+    }
+
+    /// The maximum number of deleted entries kept per table for re-insertion.
+    static constexpr size_t MAX_DELETED_ENTRIES = 1024;
+
+    /// @brief Remember a deleted entry so that it can be installed again later. If
+    /// `deletedEntries` is full, a random older entry is forgotten.
+    /// @param deletedEntries The deleted entries of the table.
+    /// @param key The key of the deleted entry.
+    /// @param entry The deleted entry.
+    template <typename EntryType>
+    static void recordDeletedEntry(TableState<EntryType> &deletedEntries, const std::string &key,
+                                   EntryType entry) {
+        if (deletedEntries.size() >= MAX_DELETED_ENTRIES) {
+            auto forgottenKey = deletedEntries.keyAt(deletedEntries.samplePosition());
+            deletedEntries.erase(forgottenKey);
+        }
+        deletedEntries.erase(key);
+        deletedEntries.insert(key, std::move(entry));
+    }
+
+    /// @brief Pick a deleted entry to install again, with the configured reinsert probability.
+    /// The entry is chosen according to the configured key popularity and forgotten.
+    /// @param deletedEntries The deleted entries of the table.
+    /// @return The key and the entry or std::nullopt if no entry is installed again.
+    template <typename EntryType>
+    std::optional<std::pair<std::string, EntryType>> takeDeletedEntry(
+        TableState<EntryType> &deletedEntries) const {
+        const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+        if (deletedEntries.empty() || getRandUnit() >= fuzzerConfig.getReinsertProbability()) {
+            return std::nullopt;
+        }
+        auto position = deletedEntries.samplePosition(fuzzerConfig.getKeyPopularity());
+        std::pair<std::string, EntryType> result(deletedEntries.keyAt(position),
+                                                 std::move(deletedEntries.entryAt(position)));
+        deletedEntries.erase(result.first);
+        return result;
+    }
+
+    /// @returns the number of read requests to send in a time step. The expected number is the
+    /// configured read ratio.
+    [[nodiscard]] size_t produceReadCount() const;
+
+    /// @returns the phases of the update series. Without configured phases, the series is a
+    /// single phase with a random number of time steps, bounded by the configured maximum update
+    /// count, uniform delays from the configured range, and `maxEntryGenCnt` updates per table.
+    [[nodiscard]] std::vector<WorkloadPhase> getWorkloadPhases() const;
+
+    /// @brief Produce the next time steps of the update series defined by the configured workload
+    /// phases. Successive calls continue the series where the previous call stopped.
+    /// @param maxSteps The maximum number of time steps to produce.
+    /// @param produceStepUpdates Called once per time step with a
+    /// `WriteRequestBatcher<RequestType>`, whether the phase only inserts, and the maximum number
+    /// of updates per table of the step.
+    /// @param produceReadRequest Called after the writes of a time step for every read request of
+    /// the step. Returns a `ProtobufMessagePtr`, nullptr if there is nothing to read.
+    /// With a checkpoint, the time steps completed before the checkpoint was taken are skipped,
+    /// the write requests of every time step are journaled, and a new epoch is started every
+    /// checkpoint interval. The series stops early if the checkpoint can not be written.
+    /// @return The requests of the time steps, empty if the series has ended.
+    template <typename RequestType, typename ProduceUpdates, typename ProduceReadRequest>
+    UpdateSeries produceBatchedUpdateSteps(size_t maxSteps, ProduceUpdates &&produceStepUpdates,
+                                           ProduceReadRequest &&produceReadRequest) {
+        const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+        WriteRequestBatcher<RequestType> batcher(fuzzerConfig.getMaxUpdatesPerRequest(),
+                                                 fuzzerConfig.getMaxBytesPerRequest());
+        UpdateSeries updateSeries;
+        size_t stepInPhase = 0;
+        for (size_t numSteps = 0; numSteps < maxSteps; ++numSteps) {
+            const auto *phase = nextWorkloadStep(stepInPhase);
+            if (phase == nullptr) {
+                break;
+            }
+            auto microseconds = phase->arrivalProcess.sampleDelay(stepInPhase, phase->numSteps);
+            produceStepUpdates(batcher, phase->insertOnly, phase->stepSize.sample());
+            batcher.flush();
+            auto requests = batcher.takeRequests();
+            // Keep the time step even if it does not contain any updates.
+            if (requests.empty()) {
+                requests.push_back(std::make_unique<RequestType>());
+            }
+            auto firstRequest = updateSeries.size();
+            // The remaining requests of the time step are sent in a burst.
+            for (auto &request : requests) {
+                if (checkpoint != nullptr) {
+                    checkpoint->appendToJournal(*request);
+                }
+                updateSeries.emplace_back(std::exchange(microseconds, 0), std::move(request));
+            }
+            // Reads observe the state after the writes of the time step.
+            for (size_t readCount = produceReadCount(); readCount > 0; --readCount) {
+                if (auto readRequest = produceReadRequest()) {
+                    updateSeries.emplace_back(0, std::move(readRequest));
+                }
+            }
+            auto numRequests = updateSeries.size() - firstRequest;
+            if (deferStepCompletion) {
+                uncompletedStepRequests = numRequests;
+            } else if (!completeStep(numRequests)) {
+                break;
+            }
+        }
+        return updateSeries;
+    }
+
+    /// @brief Produce the table entry updates of a single time step for `table` and add them to
+    /// `batcher`. New entries respect the capacity of the table, deleted entries are installed
+    /// again with the configured reinsert probability, and every key is touched at most once, as
+    /// the updates of a request may be applied in any order.
+    /// @param table The table.
+    /// @param policy The generation policy of the table.
+    /// @param tableState The installed entries of the table.
+    /// @param deletedTableEntries The deleted entries of the table that may be installed again.
+    /// @param isInitialConfig Whether the updates belong to the initial configuration. It only
+    /// inserts, up to the entry count of the policy, and never installs deleted entries again.
+    /// @param insertOnly Only insert entries in a time step of an insert-only workload phase.
+    /// @param maxUpdatesPerTable The maximum number of updates of the table.
+    /// @param batcher Packs the updates into requests.
+    /// @param produceEntry Returns a new random entry of the table.
+    /// @param computeKey Returns the canonical key of an entry.
+    /// @param produceUpdate Called with the `UpdateOperation`, the key, and the entry before the
+    /// table state changes. A modification changes the entry in place. Returns the update.
+    template <typename RequestType, typename EntryType, typename ProduceEntry, typename ComputeKey,
+              typename ProduceUpdate>
+    void produceTableEntryUpdates(const p4::config::v1::Table &table, const TablePolicy &policy,
+                                  TableState<EntryType> &tableState,
+                                  TableState<EntryType> &deletedTableEntries,
+                                  bool isInitialConfig, bool insertOnly,
+                                  uint64_t maxUpdatesPerTable,
+                                  WriteRequestBatcher<RequestType> &batcher,
+                                  ProduceEntry &&produceEntry, ComputeKey &&computeKey,
+                                  ProduceUpdate &&produceUpdate) {
+        const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+        uint64_t attempts = 0;
+        // Try to keep track of the entries we have generated so far.
+        uint64_t count = 0;
+        auto maxUpdates = isInitialConfig ? policy.entryCount.value_or(maxUpdatesPerTable)
+                                          : maxUpdatesPerTable;
+        auto capacity = getTableCapacity(table, policy);
+        std::set<std::string> touchedKeys;
+        while (count < maxUpdates) {
+            // Only failed attempts count, so that large entry counts can be reached.
+            if (attempts - count > static_cast<uint64_t>(fuzzerConfig.getMaxAttempts())) {
+                warning("Failed to generate %d entries for table %s", maxUpdates,
+                        table.preamble().name());
+                break;
+            }
+            attempts++;
+            auto isFull = capacity.has_value() && tableState.size() >= capacity.value();
+            // In case of an initial config or an insert-only phase we only insert entries. A full
+            // table can only be modified or emptied.
+            auto operation = isInitialConfig || insertOnly
+                                 ? UpdateOperation::Insert
+                                 : pickUpdateOperation(!tableState.empty(), policy, !isFull);
+            if (operation == UpdateOperation::Insert) {
+                // Do not fill the table beyond its capacity.
+                if (isFull) {
+                    break;
+                }
+                EntryType entry;
+                std::string entryKey;
+                // Flapping entries are installed again after they have been deleted.
+                if (auto deletedEntry =
+                        isInitialConfig ? std::nullopt : takeDeletedEntry(deletedTableEntries)) {
+                    std::tie(entryKey, entry) = std::move(deletedEntry.value());
+                } else {
+                    entry = produceEntry();
+                    entryKey = computeKey(entry);
+                }
+                // Only insert unique entries that actually insert, and keys that were not deleted
+                // earlier in the same time step.
+                if (!touchedKeys.insert(entryKey).second || tableState.contains(entryKey)) {
+                    continue;
+                }
+                batcher.add(produceUpdate(operation, entryKey, entry));
+                count++;
+                tableState.insert(entryKey, std::move(entry));
+                continue;
+            }
+
+            // Modify or delete one of the installed entries, chosen by popularity.
+            auto position = tableState.samplePosition(fuzzerConfig.getKeyPopularity());
+            auto entryKey = tableState.keyAt(position);
+            if (!touchedKeys.insert(entryKey).second) {
+                continue;
+            }
+            auto &entry = tableState.entryAt(position);
+            batcher.add(produceUpdate(operation, entryKey, entry));
+            count++;
+            if (operation == UpdateOperation::Delete) {
+                recordDeletedEntry(deletedTableEntries, entryKey, std::move(entry));
+                tableState.erase(entryKey);
+            }
+        }
+    }
+
+    /// @brief Make the length of the update series independent of the random number generator
+    /// state of a resumed run: The first run records the total number of time steps in the
+    /// checkpoint, resumed runs apply it to the default phase.
+    /// @param phases The phases of the update series.
+    void restoreSeriesLength(std::vector<WorkloadPhase> &phases) const;
+
+    /// @returns an empty write request of the control plane API of the fuzzer.
+    [[nodiscard]] virtual ProtobufMessagePtr produceEmptyWriteRequest() const = 0;
+
+    /// @returns an empty read response of the control plane API of the fuzzer.
+    [[nodiscard]] virtual ProtobufMessagePtr produceEmptyReadResponse() const = 0;
 
  public:
-    explicit RuntimeFuzzer(const ProgramInfo &programInfo) : programInfo(programInfo) {}
+    explicit RuntimeFuzzer(const ProgramInfo &programInfo);
+
+    RuntimeFuzzer(const RuntimeFuzzer &) = delete;
+    RuntimeFuzzer &operator=(const RuntimeFuzzer &) = delete;
+
+    virtual ~RuntimeFuzzer() = default;
 
     /// @brief Produce an `InitialConfig`, which is a vector of updates.
     /// @return A InitialConfig
     virtual InitialConfig produceInitialConfig() = 0;
 
-    /// @brief Produce an `UpdateSeries`, which is a vector of indexed updates.
-    /// @return A InitialConfig
-    virtual UpdateSeries produceUpdateTimeSeries() = 0;
+    /// @brief Produce the next time steps of the update series. Successive calls continue the
+    /// series where the previous call stopped.
+    /// @param maxSteps The maximum number of time steps to produce.
+    /// @return The requests of the time steps, empty if the series has ended.
+    virtual UpdateSeries produceUpdateSteps(size_t maxSteps) = 0;
+
+    /// @brief Produce the remaining time steps of the update series.
+    /// @return An `UpdateSeries`, which is a vector of delayed requests.
+    UpdateSeries produceUpdateTimeSeries();
+
+    /// @brief Pull the next request of the update series. Time steps are produced on demand, so
+    /// only the requests of a single time step are held in memory. `produceUpdateSteps` does not
+    /// return the remaining requests of a partially pulled time step. A time step is recorded as
+    /// completed in the checkpoint only when the request after its last one is pulled, so that
+    /// the requests of a resumed series continue after the last request that was fully handled.
+    /// @return The request and its delay or std::nullopt if the series has ended.
+    std::optional<TimedUpdate> nextUpdate();
+
+    /// @brief Pass the requests of the update series to `consume` one at a time, as they are
+    /// produced. If `consume` returns false, the series stops; the remaining requests are returned
+    /// by later calls to `nextUpdate` or `forEachUpdate`.
+    /// @param consume Receives the delay and the request.
+    /// @return The number of requests passed to `consume`.
+    size_t forEachUpdate(const UpdateConsumer &consume);
+
+    /// @brief Record the update series in `checkpoint`. The checkpoint must outlive the fuzzer.
+    void setCheckpoint(Checkpoint *checkpoint) { this->checkpoint = checkpoint; }
+
+    /// @brief Produce a write request that installs the current state of the fuzzer from scratch.
+    /// It only contains insertions, ordered such that references are installed first.
+    /// @return The request.
+    [[nodiscard]] virtual ProtobufMessagePtr produceStateSnapshot() const = 0;
+
+    /// @brief Apply the updates of `request` to the state of the fuzzer, as if the fuzzer had
+    /// produced them.
+    /// @param request A write request of the control plane API of the fuzzer.
+    /// @return False if the request does not belong to the program.
+    virtual bool applyWriteRequest(const google::protobuf::Message &request) = 0;
+
+    /// @brief Add the entities of `response` to the state of the fuzzer, as if the fuzzer had
+    /// inserted them. The entities are moved out of `response`.
+    /// @param response A read response of the control plane API of the fuzzer.
+    /// @return False if an entity does not belong to the program.
+    virtual bool applyReadResponse(google::protobuf::Message &response) = 0;
+
+    /// @brief Load an existing switch state into the fuzzer, so that the update series modifies
+    /// and deletes installed entries.
+    /// @param path A write request or a read response, in text or binary format.
+    /// @return False if the file can not be parsed or does not belong to the program.
+    bool loadInitialState(const std::filesystem::path &path);
+
+    /// @brief Restore the state of the fuzzer from the snapshot and the journal of `checkpoint`.
+    /// The update series continues after the last completed time step.
+    /// @return False if the checkpoint can not be restored.
+    bool restoreFromCheckpoint();
 
     /// Some Helper functions below
 
@@ -67,9 +450,74 @@ class RuntimeFuzzer {
 
     static bool tableHasFieldType(const p4::config::v1::Table &table,
                                   const p4::config::v1::MatchField::MatchType type);
+
+    /// @brief Find the first table that uses an action profile.
+    /// @param p4Info
+    /// @param profileId
+    /// @return The table or nullptr if no table uses the action profile.
+    static const p4::config::v1::Table *findActionProfileTable(
+        const p4::config::v1::P4Info &p4Info, uint32_t profileId);
+
+    /// @brief Find an action profile by id. The action profile must exist.
+    /// @param p4Info
+    /// @param profileId
+    /// @return The action profile.
+    static const p4::config::v1::ActionProfile &findActionProfile(
+        const p4::config::v1::P4Info &p4Info, uint32_t profileId);
+
+    /// @brief Draw distinct ids uniformly at random.
+    /// @param count The number of ids to draw. Must not exceed `numIds`.
+    /// @param numIds The ids to draw from are [1, numIds].
+    /// @return The ids in random order.
+    static std::vector<uint32_t> sampleDistinctIds(size_t count, size_t numIds);
+
+ protected:
+    /// @returns the largest group size allowed for the action selector @param profile.
+    [[nodiscard]] int getMaxGroupSize(const p4::config::v1::ActionProfile &profile) const;
+
+    /// @brief Draw the size of a new group of the action selector `profile` from the configured
+    /// group size range.
+    /// @param profile
+    /// @param numMembers The number of members of the action profile. Limits the group size.
+    /// @return The group size, at least 1 if `numMembers` is positive.
+    [[nodiscard]] size_t produceGroupSize(const p4::config::v1::ActionProfile &profile,
+                                          size_t numMembers) const;
 };
 
 class P4RuntimeFuzzer : public RuntimeFuzzer {
+ protected:
+    /// The entries currently installed in each table, keyed by the table name.
+    std::map<std::string, TableState<p4::v1::TableEntry>> currentState;
+
+    /// The recently deleted entries of each table, keyed by the table name.
+    std::map<std::string, TableState<p4::v1::TableEntry>> deletedEntries;
+
+    /// The members and groups of each action profile, keyed by the action profile name. Members
+    /// and groups are keyed by their id. They are never deleted because table entries may refer
+    /// to them.
+    std::map<std::string, TableState<p4::v1::ActionProfileMember>> actionProfileMembers;
+    std::map<std::string, TableState<p4::v1::ActionProfileGroup>> actionProfileGroups;
+
+    /// The next unused member and group id of each action profile, keyed by the action profile
+    /// name. Ids start at 1 and are not reused.
+    std::map<std::string, uint32_t> nextMemberIds;
+    std::map<std::string, uint32_t> nextGroupIds;
+
+    /// Whether the tables of an action selector are programmed with one-shot action sets, keyed by
+    /// the action profile name. P4Runtime servers do not have to support mixing one-shot and
+    /// member/group programming, so the mode is chosen once per action selector.
+    std::map<std::string, bool> oneShotSelectors;
+
+    /// @returns true if the tables of @param profile are programmed with one-shot action sets.
+    bool usesOneShotProgramming(const p4::config::v1::ActionProfile &profile);
+
+    /// The overlap indices of the tables with an overlap target, keyed by the table name.
+    std::map<std::string, OverlapIndex> overlapIndices;
+
+    /// @returns the overlap index of @param table or nullptr if @param policy does not set an
+    /// overlap target for the table.
+    OverlapIndex *getOverlapIndex(const p4::config::v1::Table &table, const TablePolicy &policy);
+
  public:
     explicit P4RuntimeFuzzer(const ProgramInfo &programInfo) : RuntimeFuzzer(programInfo) {}
 
@@ -80,8 +528,9 @@ class P4RuntimeFuzzer : public RuntimeFuzzer {
 
     /// @brief Produce a FieldMatch_LPM with bitwidth
     /// @param bitwidth
+    /// @param policy Decides the range of the prefix length.
     /// @return A FieldMatch_LPM
-    virtual p4::v1::FieldMatch_LPM produceFieldMatch_LPM(int bitwidth);
+    virtual p4::v1::FieldMatch_LPM produceFieldMatch_LPM(int bitwidth, const TablePolicy &policy);
 
     /// @brief Produce a FieldMatch_Ternary with bitwidth
     /// @param bitwidth
@@ -111,6 +560,92 @@ class P4RuntimeFuzzer : public RuntimeFuzzer {
         const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &action_refs,
         const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
 
+    /// @brief Produce a weight for a member of a group or a one-shot action set.
+    /// @return A weight in [1, maxMemberWeight].
+    virtual int32_t produceMemberWeight();
+
+    /// @brief Produce a member with a random action for an action profile.
+    /// @param profile
+    /// @param memberId
+    /// @param actionRefs The actions of the tables that use the profile.
+    /// @param actions
+    /// @return An `ActionProfileMember`
+    virtual p4::v1::ActionProfileMember produceActionProfileMember(
+        const p4::config::v1::ActionProfile &profile, uint32_t memberId,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &actionRefs,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
+
+    /// @brief Produce a group of distinct existing members for an action selector. The group size
+    /// is drawn from the configured group size range.
+    /// @param profile
+    /// @param groupId
+    /// @param members The members of the action profile.
+    /// @return An `ActionProfileGroup`
+    virtual p4::v1::ActionProfileGroup produceActionProfileGroup(
+        const p4::config::v1::ActionProfile &profile, uint32_t groupId,
+        const TableState<p4::v1::ActionProfileMember> &members);
+
+    /// @brief Add a member to or remove a member from `group`, keeping its size within the
+    /// configured group size range.
+    /// @param profile
+    /// @param group
+    /// @param members The members of the action profile.
+    void churnActionProfileGroup(const p4::config::v1::ActionProfile &profile,
+                                 p4::v1::ActionProfileGroup &group,
+                                 const TableState<p4::v1::ActionProfileMember> &members);
+
+    /// @brief Produce a one-shot action set with weighted random actions for an action selector.
+    /// @param profile
+    /// @param actionRefs The actions of the table.
+    /// @param actions
+    /// @return An `ActionProfileActionSet`
+    virtual p4::v1::ActionProfileActionSet produceActionProfileActionSet(
+        const p4::config::v1::ActionProfile &profile,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &actionRefs,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
+
+    /// @brief Produce the action of an entry of `table`. Tables with an action profile refer to
+    /// an existing member or group or use a one-shot action set, all other tables use a random
+    /// action.
+    /// @param table
+    /// @param actions
+    /// @return A `TableAction`
+    p4::v1::TableAction produceEntryAction(
+        const p4::config::v1::Table &table,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
+
+    /// @brief Produce the member and group updates of all action profiles and add them to
+    /// `batcher`. Members, groups, and the table entries referring to them are put into separate
+    /// requests, so that references are always installed first.
+    /// @param isInitialConfig The initial configuration installs members and groups, updates
+    /// modify the actions of members and the membership of groups.
+    /// @param batcher Packs the updates into `WriteRequest`s.
+    void produceActionProfileUpdates(bool isInitialConfig,
+                                     WriteRequestBatcher<p4::v1::WriteRequest> &batcher);
+
+    /// @brief Produce a random meter configuration. The peak rate and burst are at least as large
+    /// as the committed rate and burst.
+    /// @param spec The spec of the meter. Byte meters use larger rates than packet meters.
+    /// @return A `MeterConfig`
+    virtual p4::v1::MeterConfig produceMeterConfig(const p4::config::v1::MeterSpec &spec);
+
+    /// @brief Produce a random value for a register cell.
+    /// @param typeSpec The type of the register cells.
+    /// @return The value or std::nullopt if the register is not a bit string.
+    virtual std::optional<p4::v1::P4Data> produceRegisterData(
+        const p4::config::v1::P4DataTypeSpec &typeSpec);
+
+    /// @brief Produce the meter, counter, and register updates of all resources in the program
+    /// and add them to `batcher`. Indexed resources are only modified, at indices below their
+    /// declared size. Direct resources are modified for installed table entries. Counters are
+    /// reset to 0. The updates are put into a request of their own after the table entries they
+    /// may refer to.
+    /// @param isInitialConfig The initial configuration writes up to `maxEntryGenCnt` cells of
+    /// every resource. Updates rewrite single cells of randomly chosen resources.
+    /// @param batcher Packs the updates into `WriteRequest`s.
+    void produceResourceUpdates(bool isInitialConfig,
+                                WriteRequestBatcher<p4::v1::WriteRequest> &batcher);
+
     /// @brief Produce priority for an entry given match fields
     /// @param matchFields
     /// @return A 32-bit integer
@@ -119,22 +654,93 @@ class P4RuntimeFuzzer : public RuntimeFuzzer {
 
     /// @brief Produce match field given match type
     /// @param match
+    /// @param policy The generation policy of the table.
     /// @return A `FieldMatch`
-    virtual p4::v1::FieldMatch produceMatchField(p4::config::v1::MatchField &match);
+    virtual p4::v1::FieldMatch produceMatchField(p4::config::v1::MatchField &match,
+                                                 const TablePolicy &policy);
 
-    /// @brief Produce a `TableEntry` with id, match fields, priority and action
+    /// @brief Produce a `TableEntry` with id, match fields, priority and action. Ternary fields
+    /// that are wildcards are omitted.
     /// @param table
     /// @param actions
+    /// @param policy The generation policy of the table.
     /// @return A `TableEntry`
     virtual p4::v1::TableEntry produceTableEntry(
         const p4::config::v1::Table &table,
-        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+        const TablePolicy &policy);
+
+    /// @brief Produce a `TableEntry` whose match space overlaps with the match space of `anchor`.
+    /// Key fields are derived from the anchor, the action and priority are random.
+    /// @param table
+    /// @param actions
+    /// @param anchor The match space of an existing entry of the table.
+    /// @param policy The generation policy of the table.
+    /// @return A `TableEntry`
+    virtual p4::v1::TableEntry produceOverlappingTableEntry(
+        const p4::config::v1::Table &table,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+        const EntryRegion &anchor, const TablePolicy &policy);
+
+    /// @brief Produce a `TableEntry` for a table. If the policy of the table has an overlap
+    /// target, the entry is chosen to steer the average overlap degree of the table towards the
+    /// target.
+    /// @param table
+    /// @param actions
+    /// @param policy The generation policy of the table.
+    /// @return A `TableEntry`
+    p4::v1::TableEntry produceTableEntryForOverlapTarget(
+        const p4::config::v1::Table &table,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+        const TablePolicy &policy);
+
+    /// @brief Compute the match space covered by `entry`.
+    /// @param table The table `entry` belongs to.
+    /// @param entry
+    /// @return One region per key field of the table, in key order.
+    static EntryRegion computeEntryRegion(const p4::config::v1::Table &table,
+                                          const p4::v1::TableEntry &entry);
+
+    /// @brief Compute the canonical key of `entry`. Two entries of a table have the same key if and
+    /// only if they have the same match fields, independent of the order of the fields.
+    /// @param entry
+    /// @return The key as a byte string.
+    static std::string computeEntryKey(const p4::v1::TableEntry &entry);
+
+    /// @brief Produce the table entry updates of a single time step and add them to `batcher`.
+    /// @param isInitialConfig describes whether the updates are generated in the context of an
+    /// initial configuration (no updates or deletes are used there). Otherwise, modifications and
+    /// deletions target entries that are currently installed. A modification only changes the
+    /// action of the entry.
+    /// @param batcher Packs the updates into `WriteRequest`s.
+    /// @param maxUpdatesPerTable The maximum number of updates per table. The entry count of the
+    /// policy of a table overrides it in the initial configuration.
+    /// @param insertOnly Only insert entries in a time step of an insert-only workload phase.
+    void produceUpdates(bool isInitialConfig, WriteRequestBatcher<p4::v1::WriteRequest> &batcher,
+                        uint64_t maxUpdatesPerTable, bool insertOnly = false);
+
+    /// @brief Produce a `ReadRequest` with a single entity. The entity is a wildcard read of a
+    /// table, a read of an installed table entry, or a read of a counter, direct counter, register,
+    /// or meter. Indexed and direct resources are read either entirely or for a single index or
+    /// installed entry.
+    /// @return The request or nullptr if the program has nothing to read.
+    virtual std::unique_ptr<p4::v1::ReadRequest> produceReadRequest();
+
+    /// @brief Apply a single update of a write request to the state of the fuzzer. Table entries,
+    /// action profile members, and action profile groups are tracked, other entities are ignored.
+    /// @param update
+    /// @return False if the update refers to an object that does not exist in the program.
+    virtual bool applyUpdate(const p4::v1::Update &update);
+
+    [[nodiscard]] ProtobufMessagePtr produceEmptyWriteRequest() const override;
+
+    [[nodiscard]] ProtobufMessagePtr produceEmptyReadResponse() const override;
+
+    [[nodiscard]] ProtobufMessagePtr produceStateSnapshot() const override;
+
+    bool applyWriteRequest(const google::protobuf::Message &request) override;
 
-    /// @brief Produce a `WriteRequest` with a vector of `TableEntry`.
-    /// @param isInitialConfig describes whether the write request is generated in the context of an
-    /// initial configuration (no updates or deletes are used there).
-    /// @return A `WriteRequest`
-    std::unique_ptr<p4::v1::WriteRequest> produceWriteRequest(bool isInitialConfig);
+    bool applyReadResponse(google::protobuf::Message &response) override;
 };
 
 }  // namespace P4::P4Tools::RtSmith
@@ -0,0 +1,351 @@
+#include "backends/p4tools/modules/rtsmith/core/overlap_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "lib/exceptions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+/* =============================================================================================
+ *  FieldRegion
+ * ============================================================================================= */
+
+FieldRegion FieldRegion::masked(const big_int &value, const big_int &mask) {
+    return {Kind::Masked, value & mask, mask};
+}
+
+FieldRegion FieldRegion::interval(const big_int &low, const big_int &high) {
+    return {Kind::Interval, low, high};
+}
+
+bool FieldRegion::overlaps(const FieldRegion &other) const {
+    BUG_CHECK(kind == other.kind, "Can not compare regions of different kinds.");
+    if (kind == Kind::Masked) {
+        return ((first ^ other.first) & second & other.second) == 0;
+    }
+    return first <= other.second && other.first <= second;
+}
+
+/* =============================================================================================
+ *  Interval tree
+ * ============================================================================================= */
+
+/// A treap ordered by (low, position) where every node also tracks the largest upper bound in its
+/// subtree. Subtrees whose largest upper bound is below the query interval are skipped.
+struct OverlapIndex::IntervalNode {
+    big_int low;
+    big_int high;
+    big_int maxHigh;
+    size_t position;
+    uint64_t priority;
+    std::unique_ptr<IntervalNode> left;
+    std::unique_ptr<IntervalNode> right;
+
+    IntervalNode(big_int low, big_int high, size_t position, uint64_t priority)
+        : low(std::move(low)), high(high), maxHigh(high), position(position), priority(priority) {}
+
+    void update() {
+        maxHigh = high;
+        if (left && left->maxHigh > maxHigh) {
+            maxHigh = left->maxHigh;
+        }
+        if (right && right->maxHigh > maxHigh) {
+            maxHigh = right->maxHigh;
+        }
+    }
+
+    [[nodiscard]] bool isBefore(const big_int &otherLow, size_t otherPosition) const {
+        return low < otherLow || (low == otherLow && position < otherPosition);
+    }
+
+    static void split(std::unique_ptr<IntervalNode> node, const big_int &low, size_t position,
+                      std::unique_ptr<IntervalNode> &left, std::unique_ptr<IntervalNode> &right) {
+        if (!node) {
+            left.reset();
+            right.reset();
+            return;
+        }
+        if (node->isBefore(low, position)) {
+            split(std::move(node->right), low, position, node->right, right);
+            node->update();
+            left = std::move(node);
+        } else {
+            split(std::move(node->left), low, position, left, node->left);
+            node->update();
+            right = std::move(node);
+        }
+    }
+
+    static std::unique_ptr<IntervalNode> merge(std::unique_ptr<IntervalNode> left,
+                                               std::unique_ptr<IntervalNode> right) {
+        if (!left) {
+            return right;
+        }
+        if (!right) {
+            return left;
+        }
+        if (left->priority > right->priority) {
+            left->right = merge(std::move(left->right), std::move(right));
+            left->update();
+            return left;
+        }
+        right->left = merge(std::move(left), std::move(right->left));
+        right->update();
+        return right;
+    }
+
+    static void insert(std::unique_ptr<IntervalNode> &node, std::unique_ptr<IntervalNode> newNode) {
+        if (!node) {
+            node = std::move(newNode);
+            return;
+        }
+        if (newNode->priority > node->priority) {
+            split(std::move(node), newNode->low, newNode->position, newNode->left, newNode->right);
+            newNode->update();
+            node = std::move(newNode);
+            return;
+        }
+        if (newNode->isBefore(node->low, node->position)) {
+            insert(node->left, std::move(newNode));
+        } else {
+            insert(node->right, std::move(newNode));
+        }
+        node->update();
+    }
+
+    static bool erase(std::unique_ptr<IntervalNode> &node, const big_int &low, size_t position) {
+        if (!node) {
+            return false;
+        }
+        if (node->low == low && node->position == position) {
+            node = merge(std::move(node->left), std::move(node->right));
+            return true;
+        }
+        bool erased = node->isBefore(low, position) ? erase(node->right, low, position)
+                                                    : erase(node->left, low, position);
+        if (erased) {
+            node->update();
+        }
+        return erased;
+    }
+
+    static void collect(const IntervalNode *node, const big_int &low, const big_int &high,
+                        std::vector<size_t> &result) {
+        if (node == nullptr || node->maxHigh < low) {
+            return;
+        }
+        collect(node->left.get(), low, high, result);
+        // All nodes in the right subtree start after this node.
+        if (node->low > high) {
+            return;
+        }
+        if (node->high >= low) {
+            result.push_back(node->position);
+        }
+        collect(node->right.get(), low, high, result);
+    }
+};
+
+/* =============================================================================================
+ *  Ternary trie
+ * ============================================================================================= */
+
+/// A binary trie with an additional "don't care" child per bit, walked from the most significant
+/// bit. Leaves hold the positions of the entries whose primary field has exactly that pattern.
+struct OverlapIndex::TrieNode {
+    static constexpr size_t WILDCARD = 2;
+
+    std::array<std::unique_ptr<TrieNode>, 3> children;
+    std::vector<size_t> positions;
+
+    static size_t childIndex(const FieldRegion &region, int bit) {
+        if (!boost::multiprecision::bit_test(region.second, bit)) {
+            return WILDCARD;
+        }
+        return boost::multiprecision::bit_test(region.first, bit) ? 1 : 0;
+    }
+
+    void insert(const FieldRegion &region, int width, size_t position) {
+        auto *node = this;
+        for (int bit = width - 1; bit >= 0; --bit) {
+            auto &child = node->children.at(childIndex(region, bit));
+            if (!child) {
+                child = std::make_unique<TrieNode>();
+            }
+            node = child.get();
+        }
+        node->positions.push_back(position);
+    }
+
+    /// Remove @param position from the leaf of @param region. @returns true if this node became
+    /// empty and can be pruned.
+    bool erase(const FieldRegion &region, int bit, size_t position) {
+        if (bit < 0) {
+            auto it = std::find(positions.begin(), positions.end(), position);
+            if (it != positions.end()) {
+                *it = positions.back();
+                positions.pop_back();
+            }
+        } else {
+            auto &child = children.at(childIndex(region, bit));
+            if (child && child->erase(region, bit - 1, position)) {
+                child.reset();
+            }
+        }
+        return positions.empty() &&
+               std::none_of(children.begin(), children.end(),
+                            [](const std::unique_ptr<TrieNode> &child) { return bool(child); });
+    }
+
+    void collect(const FieldRegion &query, int bit, std::vector<size_t> &result) const {
+        if (bit < 0) {
+            result.insert(result.end(), positions.begin(), positions.end());
+            return;
+        }
+        auto queryChild = childIndex(query, bit);
+        for (size_t idx = 0; idx < children.size(); ++idx) {
+            // A concrete query bit only overlaps with the same bit or a "don't care" bit.
+            if (children.at(idx) &&
+                (queryChild == WILDCARD || idx == WILDCARD || idx == queryChild)) {
+                children.at(idx)->collect(query, bit - 1, result);
+            }
+        }
+    }
+};
+
+/* =============================================================================================
+ *  OverlapIndex
+ * ============================================================================================= */
+
+namespace {
+
+/// Mixes @param value into a well-distributed treap priority. We deliberately do not draw from the
+/// global random number generator here so that indexing does not change the generated entries.
+uint64_t mixPriority(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27U)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31U);
+}
+
+}  // namespace
+
+OverlapIndex::OverlapIndex(std::vector<FieldRegion::Kind> fieldKinds, std::vector<int> fieldWidths)
+    : fieldKinds(std::move(fieldKinds)), fieldWidths(std::move(fieldWidths)) {
+    BUG_CHECK(!this->fieldKinds.empty() && this->fieldKinds.size() == this->fieldWidths.size(),
+              "Invalid key description for the overlap index.");
+    auto rangeField = std::find(this->fieldKinds.begin(), this->fieldKinds.end(),
+                                FieldRegion::Kind::Interval);
+    if (rangeField != this->fieldKinds.end()) {
+        primaryField = std::distance(this->fieldKinds.begin(), rangeField);
+    } else {
+        trieRoot = std::make_unique<TrieNode>();
+    }
+}
+
+OverlapIndex::OverlapIndex(OverlapIndex &&) noexcept = default;
+
+OverlapIndex &OverlapIndex::operator=(OverlapIndex &&) noexcept = default;
+
+OverlapIndex::~OverlapIndex() = default;
+
+void OverlapIndex::addToPrimaryIndex(size_t position) {
+    const auto &field = entries.at(position).region.at(primaryField);
+    if (trieRoot) {
+        trieRoot->insert(field, fieldWidths.at(primaryField), position);
+        return;
+    }
+    IntervalNode::insert(intervalRoot, std::make_unique<IntervalNode>(
+                                           field.first, field.second, position,
+                                           mixPriority(insertionCount++)));
+}
+
+void OverlapIndex::removeFromPrimaryIndex(size_t position) {
+    const auto &field = entries.at(position).region.at(primaryField);
+    if (trieRoot) {
+        trieRoot->erase(field, fieldWidths.at(primaryField) - 1, position);
+        return;
+    }
+    IntervalNode::erase(intervalRoot, field.first, position);
+}
+
+void OverlapIndex::collectCandidates(const FieldRegion &region,
+                                     std::vector<size_t> &candidates) const {
+    if (trieRoot) {
+        trieRoot->collect(region, fieldWidths.at(primaryField) - 1, candidates);
+        return;
+    }
+    IntervalNode::collect(intervalRoot.get(), region.first, region.second, candidates);
+}
+
+size_t OverlapIndex::countOverlapsExcept(const EntryRegion &region, size_t self) const {
+    BUG_CHECK(region.size() == fieldKinds.size(), "Entry has %1% key fields, expected %2%.",
+              region.size(), fieldKinds.size());
+    std::vector<size_t> candidates;
+    collectCandidates(region.at(primaryField), candidates);
+    size_t overlaps = 0;
+    for (auto candidate : candidates) {
+        if (candidate == self) {
+            continue;
+        }
+        const auto &candidateRegion = entries.at(candidate).region;
+        bool overlapsAll = true;
+        for (size_t idx = 0; idx < region.size() && overlapsAll; ++idx) {
+            overlapsAll = idx == primaryField || region.at(idx).overlaps(candidateRegion.at(idx));
+        }
+        overlaps += overlapsAll ? 1 : 0;
+    }
+    return overlaps;
+}
+
+size_t OverlapIndex::countOverlaps(const EntryRegion &region) const {
+    return countOverlapsExcept(region, entries.size());
+}
+
+size_t OverlapIndex::insert(const std::string &key, EntryRegion region) {
+    erase(key);
+    auto overlaps = countOverlaps(region);
+    auto position = entries.size();
+    entries.push_back({key, std::move(region)});
+    positions.emplace(key, position);
+    addToPrimaryIndex(position);
+    overlappingPairs += overlaps;
+    return overlaps;
+}
+
+bool OverlapIndex::erase(const std::string &key) {
+    auto it = positions.find(key);
+    if (it == positions.end()) {
+        return false;
+    }
+    auto position = it->second;
+    positions.erase(it);
+    overlappingPairs -= countOverlapsExcept(entries.at(position).region, position);
+    removeFromPrimaryIndex(position);
+    // Keep the entries dense by moving the last entry into the freed slot.
+    auto last = entries.size() - 1;
+    if (position != last) {
+        removeFromPrimaryIndex(last);
+        entries.at(position) = std::move(entries.at(last));
+        positions.at(entries.at(position).key) = position;
+        addToPrimaryIndex(position);
+    }
+    entries.pop_back();
+    return true;
+}
+
+const EntryRegion &OverlapIndex::sampleEntry() const {
+    BUG_CHECK(!entries.empty(), "Can not sample from an empty overlap index.");
+    return entries.at(Utils::getRandInt(entries.size() - 1)).region;
+}
+
+double OverlapIndex::averageOverlapDegree() const {
+    if (entries.empty()) {
+        return 0.0;
+    }
+    return 2.0 * static_cast<double>(overlappingPairs) / static_cast<double>(entries.size());
+}
+
+}  // namespace P4::P4Tools::RtSmith
@@ -0,0 +1,132 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_OVERLAP_INDEX_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_OVERLAP_INDEX_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lib/big_int.h"
+
+namespace P4::P4Tools::RtSmith {
+
+/// The match space covered by a single key field of a table entry.
+/// Exact, LPM, optional, and ternary fields are all represented as a value/mask pair. Range fields
+/// are represented as a closed interval.
+struct FieldRegion {
+    enum class Kind { Masked, Interval };
+
+    Kind kind;
+    /// The value for masked fields, the lower bound for interval fields.
+    big_int first;
+    /// The mask for masked fields, the upper bound for interval fields.
+    big_int second;
+
+    /// @returns a masked region. Value bits outside of the mask are ignored.
+    static FieldRegion masked(const big_int &value, const big_int &mask);
+
+    /// @returns an interval region covering [low, high].
+    static FieldRegion interval(const big_int &low, const big_int &high);
+
+    /// @returns true if there is at least one key that is contained in both regions.
+    [[nodiscard]] bool overlaps(const FieldRegion &other) const;
+};
+
+using EntryRegion = std::vector<FieldRegion>;
+
+/// Indexes the match space of the entries installed in a single table so that the entries which
+/// overlap with a new entry can be found without scanning the whole table. Two entries overlap if
+/// all of their key fields overlap.
+/// The index is built on a single "primary" field of the table: An interval tree if the table has a
+/// range field, a ternary trie otherwise. All other fields are checked on the candidates the
+/// primary index returns.
+class OverlapIndex {
+ public:
+    /// @param fieldKinds The region kind of each key field of the table, in key order.
+    /// @param fieldWidths The bit width of each key field of the table, in key order.
+    OverlapIndex(std::vector<FieldRegion::Kind> fieldKinds, std::vector<int> fieldWidths);
+
+    OverlapIndex(const OverlapIndex &) = delete;
+    OverlapIndex(OverlapIndex &&) noexcept;
+    OverlapIndex &operator=(const OverlapIndex &) = delete;
+    OverlapIndex &operator=(OverlapIndex &&) noexcept;
+    ~OverlapIndex();
+
+    /// Add an entry identified by @param key to the index.
+    /// @returns the number of entries already in the index that the new entry overlaps with.
+    size_t insert(const std::string &key, EntryRegion region);
+
+    /// Remove the entry identified by @param key from the index.
+    /// @returns false if the entry is not part of the index.
+    bool erase(const std::string &key);
+
+    /// @returns the number of indexed entries that overlap with @param region.
+    [[nodiscard]] size_t countOverlaps(const EntryRegion &region) const;
+
+    /// @returns the region of an indexed entry, chosen uniformly at random. The index must not be
+    /// empty.
+    [[nodiscard]] const EntryRegion &sampleEntry() const;
+
+    /// @returns the average number of other indexed entries each indexed entry overlaps with.
+    [[nodiscard]] double averageOverlapDegree() const;
+
+    /// @returns the number of indexed entries.
+    [[nodiscard]] size_t size() const { return entries.size(); }
+
+    /// @returns true if the index contains no entries.
+    [[nodiscard]] bool empty() const { return entries.empty(); }
+
+ private:
+    struct IntervalNode;
+    struct TrieNode;
+
+    struct IndexedEntry {
+        std::string key;
+        EntryRegion region;
+    };
+
+    /// The kind of each key field.
+    std::vector<FieldRegion::Kind> fieldKinds;
+
+    /// The bit width of each key field.
+    std::vector<int> fieldWidths;
+
+    /// The key field the primary index is built on.
+    size_t primaryField = 0;
+
+    /// The indexed entries. Dense, so that sampling is O(1).
+    std::vector<IndexedEntry> entries;
+
+    /// Maps the entry key to its position in @ref entries.
+    std::unordered_map<std::string, size_t> positions;
+
+    /// Number of unordered pairs of indexed entries that overlap.
+    size_t overlappingPairs = 0;
+
+    /// Number of insertions so far. Used to derive the priorities of the interval tree.
+    uint64_t insertionCount = 0;
+
+    /// Root of the interval tree, if the primary field is a range.
+    std::unique_ptr<IntervalNode> intervalRoot;
+
+    /// Root of the ternary trie, if the primary field is a masked field.
+    std::unique_ptr<TrieNode> trieRoot;
+
+    /// Collect the positions of all entries whose primary field overlaps with @param region.
+    void collectCandidates(const FieldRegion &region, std::vector<size_t> &candidates) const;
+
+    /// Add or remove the entry at @param position to or from the primary index.
+    void addToPrimaryIndex(size_t position);
+    void removeFromPrimaryIndex(size_t position);
+
+    /// @returns the number of indexed entries other than the one at @param self overlapping with
+    /// @param region.
+    [[nodiscard]] size_t countOverlapsExcept(const EntryRegion &region, size_t self) const;
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_OVERLAP_INDEX_H_ */
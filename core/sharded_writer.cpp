@@ -0,0 +1,284 @@
+#include "backends/p4tools/modules/rtsmith/core/sharded_writer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <utility>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/text_format.h>
+#pragma GCC diagnostic pop
+
+#include "lib/error.h"
+#include "lib/exceptions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+namespace {
+
+/// A contiguous run of the updates of a single request.
+struct UpdateRange {
+    /// The request the updates belong to.
+    const google::protobuf::Message *request;
+
+    /// The index of the first update and the index after the last update.
+    int begin;
+    int end;
+};
+
+/// The updates of a shard, before they are written.
+struct Shard {
+    /// The updates of the shard, in order.
+    std::vector<UpdateRange> ranges;
+
+    /// The stage of the shard.
+    size_t stage = 0;
+
+    /// The table or object the updates belong to, empty if the shard mixes several.
+    std::string key;
+
+    /// The number of updates in the shard.
+    uint64_t numUpdates = 0;
+};
+
+/// @returns the "updates" field of @param request.
+const google::protobuf::FieldDescriptor *getUpdatesField(const google::protobuf::Message &request) {
+    const auto *field = request.GetDescriptor()->FindFieldByName("updates");
+    BUG_CHECK(field != nullptr && field->is_repeated() &&
+                  field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE,
+              "%1% is not a write request.", request.GetDescriptor()->full_name());
+    return field;
+}
+
+/// @returns the kind of the entity @param update changes and the table or object it belongs to.
+/// The kind is the name of the entity field that is set. The object is identified by the first
+/// field of the entity if it is an integer, as the table id of table entries or the action profile
+/// id of action profile members.
+std::pair<std::string, std::string> getEntityKindAndKey(const google::protobuf::Message &update) {
+    const auto *entityField = update.GetDescriptor()->FindFieldByName("entity");
+    if (entityField == nullptr ||
+        entityField->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+        return {};
+    }
+    const auto &entity = update.GetReflection()->GetMessage(update, entityField);
+    std::vector<const google::protobuf::FieldDescriptor *> setFields;
+    entity.GetReflection()->ListFields(entity, &setFields);
+    if (setFields.empty() ||
+        setFields.front()->cpp_type() != google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE) {
+        return {};
+    }
+    const auto *kindField = setFields.front();
+    const auto &object = entity.GetReflection()->GetMessage(entity, kindField);
+    const auto *idField = object.GetDescriptor()->FindFieldByNumber(1);
+    if (idField == nullptr || idField->is_repeated()) {
+        return {kindField->name(), kindField->name()};
+    }
+    const auto *reflection = object.GetReflection();
+    const auto &kind = kindField->name();
+    switch (idField->cpp_type()) {
+        case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+            return {kind, kind + ":" + std::to_string(reflection->GetUInt32(object, idField))};
+        case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+            return {kind, kind + ":" + std::to_string(reflection->GetUInt64(object, idField))};
+        default:
+            return {kind, kind};
+    }
+}
+
+/// Split the updates of @param requests into shards according to @param policy.
+std::vector<Shard> partition(
+    const std::vector<std::unique_ptr<google::protobuf::Message>> &requests,
+    const ShardingPolicy &policy) {
+    std::vector<Shard> shards;
+    std::optional<std::string> previousKind;
+    size_t stage = 0;
+    for (const auto &request : requests) {
+        const auto *updatesField = getUpdatesField(*request);
+        const auto *reflection = request->GetReflection();
+        auto numUpdates = reflection->FieldSize(*request, updatesField);
+        for (int idx = 0; idx < numUpdates; ++idx) {
+            auto [kind, key] =
+                getEntityKindAndKey(reflection->GetRepeatedMessage(*request, updatesField, idx));
+            auto isNewStage = previousKind.has_value() && kind != previousKind.value();
+            stage += isNewStage ? 1 : 0;
+            previousKind = kind;
+            auto needsNewShard =
+                shards.empty() || isNewStage || (policy.byTable && key != shards.back().key) ||
+                (policy.maxUpdates > 0 && shards.back().numUpdates >= policy.maxUpdates);
+            if (needsNewShard) {
+                shards.emplace_back();
+                shards.back().stage = stage;
+                shards.back().key = key;
+            }
+            auto &shard = shards.back();
+            if (shard.key != key) {
+                shard.key.clear();
+            }
+            if (!shard.ranges.empty() && shard.ranges.back().request == request.get() &&
+                shard.ranges.back().end == idx) {
+                shard.ranges.back().end = idx + 1;
+            } else {
+                shard.ranges.push_back({request.get(), idx, idx + 1});
+            }
+            shard.numUpdates++;
+        }
+    }
+    return shards;
+}
+
+/// @returns the text format of @param request without its updates.
+std::string printHeader(const google::protobuf::Message &request,
+                        const google::protobuf::TextFormat::Printer &printer) {
+    std::unique_ptr<google::protobuf::Message> header(request.New());
+    header->CopyFrom(request);
+    header->GetReflection()->ClearField(header.get(), getUpdatesField(request));
+    std::string text;
+    printer.PrintToString(*header, &text);
+    return text;
+}
+
+/// @returns @param text escaped for a JSON string.
+std::string escapeJson(const std::string &text) {
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (auto character : text) {
+        if (character == '"' || character == '\\') {
+            escaped += '\\';
+        }
+        escaped += character;
+    }
+    return escaped;
+}
+
+}  // namespace
+
+ShardedConfigWriter::ShardedConfigWriter(ShardingPolicy policy, Compression compression)
+    : policy(policy), compression(compression) {}
+
+std::filesystem::path ShardedConfigWriter::getManifestPath(const std::filesystem::path &basePath) {
+    auto manifestPath = basePath;
+    return manifestPath.replace_extension(".manifest.json");
+}
+
+std::optional<std::vector<ShardedConfigWriter::ShardFile>> ShardedConfigWriter::write(
+    const std::vector<std::unique_ptr<google::protobuf::Message>> &requests,
+    const std::filesystem::path &basePath) const {
+    auto shards = partition(requests, policy);
+
+    google::protobuf::TextFormat::Printer printer;
+    printer.SetExpandAny(true);
+    google::protobuf::TextFormat::Printer updatePrinter;
+    updatePrinter.SetExpandAny(true);
+    updatePrinter.SetInitialIndentLevel(1);
+    // Headers are printed once per request, before the shards are written concurrently.
+    std::map<const google::protobuf::Message *, std::string> headers;
+    for (const auto &request : requests) {
+        headers.emplace(request.get(), printHeader(*request, printer));
+    }
+
+    auto getShardPath = [&basePath](size_t shardIndex, size_t part) {
+        auto path = basePath;
+        path.replace_filename(basePath.stem().string() + ".shard_" + std::to_string(shardIndex) +
+                              "_" + std::to_string(part) + basePath.extension().string());
+        return path;
+    };
+
+    // Every shard is written by one thread. Errors are reported after all threads are done.
+    std::vector<std::vector<ShardFile>> shardFiles(shards.size());
+    std::vector<char> failed(shards.size(), 0);
+    std::atomic<size_t> nextShard = 0;
+    auto writeShards = [&]() {
+        for (auto shardIndex = nextShard++; shardIndex < shards.size();
+             shardIndex = nextShard++) {
+            const auto &shard = shards.at(shardIndex);
+            const auto &header = headers.at(shard.ranges.front().request);
+            CompressedOutputFile output;
+            ShardFile file{};
+            // The byte limit applies to the text, before compression.
+            uint64_t textBytes = 0;
+            auto openPart = [&]() {
+                auto path = getShardPath(shardIndex, shardFiles[shardIndex].size());
+                file = {getCompressedPath(path, compression), shardIndex, shard.stage, shard.key,
+                        0, 0};
+                failed[shardIndex] |= static_cast<char>(!output.open(file.path, compression));
+                failed[shardIndex] |= static_cast<char>(!output.write(header));
+                textBytes = header.size();
+            };
+            auto closePart = [&]() {
+                failed[shardIndex] |= static_cast<char>(!output.close());
+                std::error_code errorCode;
+                file.numBytes = std::filesystem::file_size(file.path, errorCode);
+                failed[shardIndex] |= static_cast<char>(static_cast<bool>(errorCode));
+                shardFiles[shardIndex].push_back(file);
+            };
+            openPart();
+            std::string text;
+            for (const auto &range : shard.ranges) {
+                const auto *updatesField = getUpdatesField(*range.request);
+                const auto *reflection = range.request->GetReflection();
+                for (int idx = range.begin; idx < range.end; ++idx) {
+                    // Continue in a new file once the byte limit is reached.
+                    if (policy.maxBytes > 0 && file.numUpdates > 0 &&
+                        textBytes >= policy.maxBytes) {
+                        closePart();
+                        openPart();
+                    }
+                    updatePrinter.PrintToString(
+                        reflection->GetRepeatedMessage(*range.request, updatesField, idx), &text);
+                    auto written = output.write("updates {\n") && output.write(text) &&
+                                   output.write("}\n");
+                    failed[shardIndex] |= static_cast<char>(!written);
+                    textBytes += text.size() + 12;
+                    file.numUpdates++;
+                }
+            }
+            closePart();
+        }
+    };
+    auto numThreads = std::max<size_t>(1, std::min(policy.numThreads, shards.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t idx = 1; idx < numThreads; ++idx) {
+        threads.emplace_back(writeShards);
+    }
+    writeShards();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::vector<ShardFile> files;
+    for (size_t shardIndex = 0; shardIndex < shards.size(); ++shardIndex) {
+        if (failed.at(shardIndex) != 0) {
+            error(ErrorType::ERR_IO, "Failed to write shard %1% of %2%", shardIndex,
+                  basePath.c_str());
+            return std::nullopt;
+        }
+        files.insert(files.end(), shardFiles.at(shardIndex).begin(),
+                     shardFiles.at(shardIndex).end());
+    }
+
+    // The manifest lists the files in the order of the configuration.
+    auto manifestPath = getManifestPath(basePath);
+    std::ofstream manifest(manifestPath, std::ios::out | std::ios::trunc);
+    manifest << "{\n  \"shards\": [\n";
+    for (size_t idx = 0; idx < files.size(); ++idx) {
+        const auto &file = files.at(idx);
+        manifest << "    {\"file\": \"" << escapeJson(file.path.filename().string())
+                 << "\", \"shard\": " << file.shard << ", \"stage\": " << file.stage
+                 << ", \"key\": \"" << escapeJson(file.key) << "\", \"updates\": "
+                 << file.numUpdates << ", \"bytes\": " << file.numBytes << "}"
+                 << (idx + 1 < files.size() ? ",\n" : "\n");
+    }
+    manifest << "  ]\n}\n";
+    manifest.close();
+    if (manifest.fail()) {
+        error(ErrorType::ERR_IO, "Failed to write the manifest %1%", manifestPath.c_str());
+        return std::nullopt;
+    }
+    return files;
+}
+
+}  // namespace P4::P4Tools::RtSmith
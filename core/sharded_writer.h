@@ -0,0 +1,98 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_SHARDED_WRITER_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_SHARDED_WRITER_H_
+
+#include <google/protobuf/message.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+
+namespace P4::P4Tools::RtSmith {
+
+/// Describes how a configuration is split into shards.
+struct ShardingPolicy {
+    /// The maximum number of updates per shard, 0 for no limit.
+    uint64_t maxUpdates = 0;
+
+    /// Whether every shard only contains the updates of a single table or object.
+    bool byTable = false;
+
+    /// The number of text bytes after which a shard continues in a new file, 0 for no limit. The
+    /// limit applies before compression.
+    uint64_t maxBytes = 0;
+
+    /// The number of shards written concurrently.
+    size_t numThreads = 1;
+
+    /// @returns true if the policy splits configurations at all.
+    [[nodiscard]] bool isEnabled() const { return maxUpdates > 0 || byTable || maxBytes > 0; }
+};
+
+/// Writes a configuration, i.e., a sequence of write requests, as text format files that are
+/// written concurrently. The updates of the requests are split into shards, which are contiguous
+/// runs of updates, so the concatenation of all shards in order reproduces the configuration.
+/// Every file is a write request with the fields of the original request and the updates of its
+/// shard. A JSON manifest lists the files in order.
+///
+/// Every shard also belongs to a stage. A new stage starts whenever the kind of the updated entity
+/// changes, e.g., from action profile members to table entries. Consumers must load stages in
+/// order, but may load the shards of a stage that belong to different tables in parallel.
+class ShardedConfigWriter {
+ public:
+    /// A file written by the writer.
+    struct ShardFile {
+        /// The path of the file.
+        std::filesystem::path path;
+
+        /// The index of the shard. A shard is split into several files if it exceeds the byte
+        /// limit.
+        size_t shard;
+
+        /// The stage of the shard.
+        size_t stage;
+
+        /// The table or object the updates of the shard belong to, empty if the shard mixes
+        /// several.
+        std::string key;
+
+        /// The number of updates in the file.
+        uint64_t numUpdates;
+
+        /// The size of the file in bytes.
+        uint64_t numBytes;
+    };
+
+ private:
+    /// The policy the configuration is split by.
+    ShardingPolicy policy;
+
+    /// The compression of the shard files.
+    Compression compression;
+
+ public:
+    explicit ShardedConfigWriter(ShardingPolicy policy,
+                                 Compression compression = Compression::None);
+
+    /// @brief Write @param requests into shards next to @param basePath. For the base path
+    /// "dir/initial_config.txtpb", the files are named "dir/initial_config.shard_<shard>_<part>
+    /// .txtpb", with the extension of the compression appended, and the manifest
+    /// "dir/initial_config.manifest.json".
+    /// @return The files in order or std::nullopt if a file can not be written.
+    [[nodiscard]] std::optional<std::vector<ShardFile>> write(
+        const std::vector<std::unique_ptr<google::protobuf::Message>> &requests,
+        const std::filesystem::path &basePath) const;
+
+    /// @returns the path of the manifest for the configuration written to @param basePath.
+    [[nodiscard]] static std::filesystem::path getManifestPath(
+        const std::filesystem::path &basePath);
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_SHARDED_WRITER_H_ */
@@ -0,0 +1,69 @@
+#include "backends/p4tools/modules/rtsmith/core/table_selector.h"
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+#include <utility>
+
+#include "backends/p4tools/modules/rtsmith/core/distributions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+TableSelector::TableSelector(const std::vector<Candidate> &candidates,
+                             const std::vector<std::string> &skipPatterns, size_t maxTables)
+    : skipped(candidates.size(), false), maxTables(maxTables) {
+    // Exact names are looked up directly, only patterns with wildcards need fnmatch.
+    std::unordered_set<std::string> exactNames;
+    std::vector<std::string> globs;
+    for (const auto &pattern : skipPatterns) {
+        if (pattern.find_first_of("*?[") == std::string::npos) {
+            exactNames.insert(pattern);
+        } else {
+            globs.push_back(pattern);
+        }
+    }
+    auto matches = [&exactNames, &globs](const std::string &name) {
+        return exactNames.count(name) != 0 ||
+               std::any_of(globs.begin(), globs.end(), [&name](const std::string &glob) {
+                   return fnmatch(glob.c_str(), name.c_str(), 0) == 0;
+               });
+    };
+
+    for (size_t index = 0; index < candidates.size(); ++index) {
+        const auto &candidate = candidates.at(index);
+        skipped[index] = std::any_of(candidate.names.begin(), candidate.names.end(), matches);
+        if (!skipped[index] && candidate.weight > 0) {
+            candidateIndices.push_back(static_cast<int>(index));
+            candidateWeights.push_back(candidate.weight);
+        }
+    }
+}
+
+bool TableSelector::isSkipped(int tableIndex) const { return skipped.at(tableIndex); }
+
+std::vector<int> TableSelector::select() const {
+    if (maxTables >= candidateIndices.size()) {
+        return candidateIndices;
+    }
+    // Compare log(u) / weight, which orders the tables like u^(1/weight) without underflowing.
+    std::vector<std::pair<double, int>> keys;
+    keys.reserve(candidateIndices.size());
+    for (size_t idx = 0; idx < candidateIndices.size(); ++idx) {
+        // Keep u in (0, 1), so that the logarithm is finite.
+        auto unit = 1.0 - getRandUnit();
+        keys.emplace_back(std::log(unit) / candidateWeights.at(idx), candidateIndices.at(idx));
+    }
+    std::nth_element(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(maxTables),
+                     keys.end(), [](const auto &a, const auto &b) { return a.first > b.first; });
+    std::vector<int> selected;
+    selected.reserve(maxTables);
+    for (size_t idx = 0; idx < maxTables; ++idx) {
+        selected.push_back(keys.at(idx).second);
+    }
+    std::sort(selected.begin(), selected.end());
+    return selected;
+}
+
+}  // namespace P4::P4Tools::RtSmith
@@ -0,0 +1,55 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TABLE_SELECTOR_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TABLE_SELECTOR_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace P4::P4Tools::RtSmith {
+
+/// Selects the tables whose entries are generated in the initial configuration or in a time step
+/// of the update series. Tables are identified by their index. Tables that match a skip pattern
+/// or have a weight of 0 are never selected. Among the other tables, up to `maxTables` are
+/// sampled without replacement, with probabilities proportional to their weights.
+class TableSelector {
+ public:
+    /// A table that may be selected.
+    struct Candidate {
+        /// The names the skip patterns are matched against, e.g., the fully qualified name and the
+        /// alias of the table.
+        std::vector<std::string> names;
+
+        /// The relative weight of the table.
+        double weight;
+    };
+
+ private:
+    /// Whether a table matches one of the skip patterns, indexed by the table index.
+    std::vector<bool> skipped;
+
+    /// The indices of the tables that may be selected and their weights.
+    std::vector<int> candidateIndices;
+    std::vector<double> candidateWeights;
+
+    /// The maximum number of tables selected at once.
+    size_t maxTables;
+
+ public:
+    /// @param candidates All tables, in table index order.
+    /// @param skipPatterns Exact table names or glob patterns (see fnmatch) of tables to skip.
+    /// @param maxTables The maximum number of tables selected at once.
+    TableSelector(const std::vector<Candidate> &candidates,
+                  const std::vector<std::string> &skipPatterns, size_t maxTables);
+
+    /// @returns true if the table at @param tableIndex matches one of the skip patterns.
+    [[nodiscard]] bool isSkipped(int tableIndex) const;
+
+    /// @brief Sample the tables with the weighted random sampling of Efraimidis and Spirakis: Every
+    /// table draws the key u^(1/weight) for a uniform u, the tables with the largest keys win.
+    /// @return The indices of the selected tables, in ascending order.
+    [[nodiscard]] std::vector<int> select() const;
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TABLE_SELECTOR_H_ */
@@ -0,0 +1,130 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TABLE_STATE_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TABLE_STATE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/rtsmith/core/distributions.h"
+#include "lib/exceptions.h"
+
+namespace P4::P4Tools::RtSmith {
+
+/// Tracks the entries that are currently installed in a control-plane table, keyed by their
+/// canonical key encoding. Entries are stored densely, which makes it possible to pick an installed
+/// entry in O(1). Lookup, insertion, and removal are O(1) on average.
+template <typename EntryType>
+class TableState {
+ private:
+    /// The installed entries and their keys.
+    std::vector<std::pair<std::string, EntryType>> entries;
+
+    /// Maps the key of an entry to its position in @ref entries.
+    std::unordered_map<std::string, size_t> positions;
+
+ public:
+    /// @returns true if an entry with @param key is installed.
+    [[nodiscard]] bool contains(const std::string &key) const {
+        return positions.find(key) != positions.end();
+    }
+
+    /// Install @param entry under @param key.
+    /// @returns false and leaves the state unchanged if an entry with the same key exists.
+    bool insert(const std::string &key, EntryType entry) {
+        if (!positions.emplace(key, entries.size()).second) {
+            return false;
+        }
+        entries.emplace_back(key, std::move(entry));
+        return true;
+    }
+
+    /// Remove the entry with @param key.
+    /// @returns false if no such entry is installed.
+    bool erase(const std::string &key) {
+        auto it = positions.find(key);
+        if (it == positions.end()) {
+            return false;
+        }
+        auto position = it->second;
+        positions.erase(it);
+        // Keep the entries dense by moving the last entry into the freed slot.
+        if (position != entries.size() - 1) {
+            entries[position] = std::move(entries.back());
+            positions[entries[position].first] = position;
+        }
+        entries.pop_back();
+        return true;
+    }
+
+    /// @returns the entry with @param key or nullptr if no such entry is installed.
+    [[nodiscard]] EntryType *find(const std::string &key) {
+        auto it = positions.find(key);
+        return it == positions.end() ? nullptr : &entries[it->second].second;
+    }
+
+    /// @returns the position of an installed entry, chosen uniformly at random.
+    [[nodiscard]] size_t samplePosition() const {
+        BUG_CHECK(!entries.empty(), "Can not sample from an empty table.");
+        return Utils::getRandInt(entries.size() - 1);
+    }
+
+    /// @returns the position of an installed entry, chosen according to @param popularity. Lower
+    /// positions are more popular. Removing an entry moves the last entry into its position.
+    [[nodiscard]] size_t samplePosition(const KeyPopularity &popularity) const {
+        BUG_CHECK(!entries.empty(), "Can not sample from an empty table.");
+        return popularity.sample(entries.size());
+    }
+
+    /// @returns the key of the entry at @param position.
+    [[nodiscard]] const std::string &keyAt(size_t position) const {
+        return entries.at(position).first;
+    }
+
+    /// @returns the entry at @param position.
+    [[nodiscard]] EntryType &entryAt(size_t position) { return entries.at(position).second; }
+    [[nodiscard]] const EntryType &entryAt(size_t position) const {
+        return entries.at(position).second;
+    }
+
+    /// @returns the number of installed entries.
+    [[nodiscard]] size_t size() const { return entries.size(); }
+
+    /// @returns true if no entry is installed.
+    [[nodiscard]] bool empty() const { return entries.empty(); }
+};
+
+/// @brief Compute the canonical key of an entry from its key fields. Two entries of a table have
+/// the same key if and only if they have the same key fields, independent of the order of the
+/// fields.
+/// @param fields The key fields of the entry. Each field must have a `field_id`.
+/// @return The key as a byte string.
+template <typename FieldRange>
+std::string computeCanonicalKey(const FieldRange &fields) {
+    using FieldType = std::decay_t<decltype(*fields.begin())>;
+    std::vector<const FieldType *> sortedFields;
+    for (const auto &field : fields) {
+        sortedFields.push_back(&field);
+    }
+    std::sort(sortedFields.begin(), sortedFields.end(),
+              [](const FieldType *left, const FieldType *right) {
+                  return left->field_id() < right->field_id();
+              });
+    std::string key;
+    for (const auto *field : sortedFields) {
+        // The serialized field is prefixed with its size so that the key is unambiguous.
+        auto serializedField = field->SerializeAsString();
+        key += std::to_string(serializedField.size());
+        key += ':';
+        key += serializedField;
+    }
+    return key;
+}
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TABLE_STATE_H_ */
@@ -1,5 +1,6 @@
 #include "backends/p4tools/modules/rtsmith/core/target.h"
 
+#include <memory>
 #include <string>
 
 #include "backends/p4tools/common/compiler/compiler_target.h"
@@ -19,7 +20,7 @@ namespace P4::P4Tools::RtSmith {
 RtSmithTarget::RtSmithTarget(const std::string &deviceName, const std::string &archName)
     : CompilerTarget(TOOL_NAME, deviceName, archName) {}
 
-const ProgramInfo *RtSmithTarget::produceProgramInfoImpl(
+std::unique_ptr<ProgramInfo> RtSmithTarget::produceProgramInfoImpl(
     const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions) const {
     const auto &program = compilerResult.getProgram();
     // Check that the program has at least one main declaration.
@@ -39,14 +40,14 @@ const ProgramInfo *RtSmithTarget::produceProgramInfoImpl(
     return produceProgramInfoImpl(compilerResult, rtSmithOptions, mainDecl);
 }
 
-RuntimeFuzzer &RtSmithTarget::getFuzzer(const ProgramInfo &programInfo) {
-    return get().getFuzzerImpl(programInfo);
+std::unique_ptr<RuntimeFuzzer> RtSmithTarget::produceFuzzer(const ProgramInfo &programInfo) {
+    return get().produceFuzzerImpl(programInfo);
 }
 
 const RtSmithTarget &RtSmithTarget::get() { return Target::get<RtSmithTarget>(TOOL_NAME); }
 
-const ProgramInfo *RtSmithTarget::produceProgramInfo(const CompilerResult &compilerResult,
-                                                     const RtSmithOptions &rtSmithOptions) {
+std::unique_ptr<ProgramInfo> RtSmithTarget::produceProgramInfo(
+    const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions) {
     return get().produceProgramInfoImpl(compilerResult, rtSmithOptions);
 }
 
@@ -1,6 +1,7 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TARGET_H_
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_TARGET_H_
 
+#include <memory>
 #include <string>
 
 #include "backends/p4tools/common/compiler/compiler_target.h"
@@ -16,28 +17,31 @@ class RtSmithTarget : public CompilerTarget {
     /// @returns the singleton instance for the current target.
     static const RtSmithTarget &get();
 
-    /// Produces a @ProgramInfo for the given P4 program.
+    /// Produces a @ProgramInfo for the given P4 program. The program info refers to
+    /// @param compilerResult, which must outlive it.
     ///
     /// @returns nullptr if the program is not supported by this target.
-    static const ProgramInfo *produceProgramInfo(const CompilerResult &compilerResult,
-                                                 const RtSmithOptions &rtSmithOptions);
+    static std::unique_ptr<ProgramInfo> produceProgramInfo(const CompilerResult &compilerResult,
+                                                           const RtSmithOptions &rtSmithOptions);
 
-    /// @returns the fuzzer that will produce an initial configuration and a series of random write
-    /// requests..
-    [[nodiscard]] static RuntimeFuzzer &getFuzzer(const ProgramInfo &programInfo);
+    /// @returns a new fuzzer that will produce an initial configuration and a series of random
+    /// write requests. The fuzzer refers to @param programInfo, which must outlive it.
+    [[nodiscard]] static std::unique_ptr<RuntimeFuzzer> produceFuzzer(
+        const ProgramInfo &programInfo);
 
  protected:
     /// @see @produceProgramInfo.
-    [[nodiscard]] virtual const ProgramInfo *produceProgramInfoImpl(
+    [[nodiscard]] virtual std::unique_ptr<ProgramInfo> produceProgramInfoImpl(
         const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions) const;
 
     /// @see @produceProgramInfo.
-    virtual const ProgramInfo *produceProgramInfoImpl(
+    virtual std::unique_ptr<ProgramInfo> produceProgramInfoImpl(
         const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions,
         const IR::Declaration_Instance *mainDecl) const = 0;
 
-    /// @see @getStepper.
-    [[nodiscard]] virtual RuntimeFuzzer &getFuzzerImpl(const ProgramInfo &programInfo) const = 0;
+    /// @see @produceFuzzer.
+    [[nodiscard]] virtual std::unique_ptr<RuntimeFuzzer> produceFuzzerImpl(
+        const ProgramInfo &programInfo) const = 0;
 
     explicit RtSmithTarget(const std::string &deviceName, const std::string &archName);
 
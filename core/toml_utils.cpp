@@ -1,6 +1,12 @@
 
 #include "backends/p4tools/modules/rtsmith/core/toml_utils.h"
 
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "backends/p4tools/modules/rtsmith/core/config.h"
 #include "lib/error.h"
 
@@ -16,80 +22,265 @@ void TOMLUtils::overrideFuzzerConfigs(FuzzerConfig &fuzzerConfig, std::filesyste
         error("ControlPlaneSmith: Failed to parse fuzzer configuration file: %1%", e.what());
     }
 
-    // For the following blocks, retrieve the configurations from the TOML file and override the
-    // default configurations if they comply with the constraints.
-    // Check if the node exists and can be casted to a pointer to a node representation of an
-    // integer. If not, do nothing and leave the default configuration as is.
-    if (const auto maxEntryGenCntValueOpt = getAndCastTOMLNode<int>(tomlConfig, "maxEntryGenCnt")) {
-        fuzzerConfig.setMaxEntryGenCnt(maxEntryGenCntValueOpt.value());
-    } else {
-        // Generate an error if the configuration is not an integer.
-        error(
-            "ControlPlaneSmith: The maximum number of entries to generate must be an "
-            "integer.");
-    }
+    overrideFuzzerConfigsImpl(fuzzerConfig, tomlConfig);
+}
 
-    if (const auto maxAttemptsValueOpt = getAndCastTOMLNode<int>(tomlConfig, "maxAttempts")) {
-        fuzzerConfig.setMaxAttempts(maxAttemptsValueOpt.value());
-    } else {
-        error("ControlPlaneSmith: The maximum number of attempts must be an integer.");
+void TOMLUtils::overrideFuzzerConfigsInString(FuzzerConfig &fuzzerConfig,
+                                              std::string configInString) {
+    toml::parse_result tomlConfig;
+    try {
+        // Note that the parameter fed into the `parse` function should be of (or could be
+        // converted to) type `std::string_view`.
+        tomlConfig = toml::parse(configInString);
+    } catch (const toml::parse_error &e) {
+        error("ControlPlaneSmith: Failed to parse fuzzer configuration string: %1%", e.what());
     }
 
-    if (const auto maxTablesValueOpt = getAndCastTOMLNode<int>(tomlConfig, "maxTables")) {
-        fuzzerConfig.setMaxTables(maxTablesValueOpt.value());
-    } else {
-        error("ControlPlaneSmith: The maximum number of tables must be an integer.");
-    }
+    overrideFuzzerConfigsImpl(fuzzerConfig, tomlConfig);
+}
 
-    if (const auto tablesToSkipValueOpt =
-            getAndCastTOMLNode<std::vector<std::string>>(tomlConfig, "tablesToSkip")) {
-        fuzzerConfig.setTablesToSkip(tablesToSkipValueOpt.value());
-    } else {
-        error("ControlPlaneSmith: The tables to skip must be an array.");
-    }
+std::optional<WorkloadPhase> TOMLUtils::parseWorkloadPhase(const toml::table &phaseTable,
+                                                           const FuzzerConfig &fuzzerConfig) {
+    // @returns the non-negative integer @param key of the phase or @param defaultValue if the
+    // phase does not set it.
+    auto getCount = [&phaseTable](const char *key,
+                                  uint64_t defaultValue) -> std::optional<uint64_t> {
+        if (!phaseTable.contains(key)) {
+            return defaultValue;
+        }
+        auto value = phaseTable[key].value<int64_t>();
+        if (!value.has_value() || value.value() < 0) {
+            error("ControlPlaneSmith: The workload phase parameter %1% must be a non-negative "
+                  "integer.",
+                  key);
+            return std::nullopt;
+        }
+        return static_cast<uint64_t>(value.value());
+    };
+    // @returns the number @param key of the phase or @param defaultValue if the phase does not
+    // set it.
+    auto getNumber = [&phaseTable](const char *key,
+                                   double defaultValue) -> std::optional<double> {
+        if (!phaseTable.contains(key)) {
+            return defaultValue;
+        }
+        auto value = phaseTable[key].value<double>();
+        if (!value.has_value()) {
+            error("ControlPlaneSmith: The workload phase parameter %1% must be a number.", key);
+        }
+        return value;
+    };
 
-    if (const auto thresholdForDeletionValueOpt =
-            getAndCastTOMLNode<uint64_t>(tomlConfig, "thresholdForDeletion")) {
-        fuzzerConfig.setThresholdForDeletion(
-            static_cast<uint64_t>(thresholdForDeletionValueOpt.value()));
-    } else {
-        error("ControlPlaneSmith: The threshold for deletion must be an integer.");
+    // @returns the string @param key of the phase or @param defaultValue if the phase does not
+    // set it.
+    auto getString = [&phaseTable](const char *key,
+                                   const char *defaultValue) -> std::optional<std::string> {
+        if (!phaseTable.contains(key)) {
+            return defaultValue;
+        }
+        auto value = phaseTable[key].value<std::string>();
+        if (!value.has_value()) {
+            error("ControlPlaneSmith: The workload phase parameter %1% must be a string.", key);
+        }
+        return value;
+    };
+
+    if (!phaseTable.contains("steps")) {
+        error("ControlPlaneSmith: Every workload phase must set the number of steps.");
+        return std::nullopt;
+    }
+    auto numSteps = getCount("steps", 0);
+    if (!numSteps.has_value()) {
+        return std::nullopt;
     }
 
-    if (const auto maxUpdateCountValueOpt =
-            getAndCastTOMLNode<size_t>(tomlConfig, "maxUpdateCount")) {
-        fuzzerConfig.setMaxUpdateCount(static_cast<size_t>(maxUpdateCountValueOpt.value()));
+    auto arrivalProcessKind = getString("arrivalProcess", "uniform");
+    if (!arrivalProcessKind.has_value()) {
+        return std::nullopt;
+    }
+    std::optional<ArrivalProcess> arrivalProcess;
+    if (arrivalProcessKind == "uniform") {
+        auto minDelay =
+            getCount("minDelayMicroseconds", fuzzerConfig.getMinUpdateTimeInMicroseconds());
+        auto maxDelay =
+            getCount("maxDelayMicroseconds", fuzzerConfig.getMaxUpdateTimeInMicroseconds());
+        if (!minDelay.has_value() || !maxDelay.has_value()) {
+            return std::nullopt;
+        }
+        if (minDelay.value() > maxDelay.value()) {
+            error("ControlPlaneSmith: The minimum delay must not exceed the maximum delay.");
+            return std::nullopt;
+        }
+        arrivalProcess = ArrivalProcess::uniform(minDelay.value(), maxDelay.value());
+    } else if (arrivalProcessKind == "poisson") {
+        auto rate = getNumber("rate", 0);
+        if (!rate.has_value()) {
+            return std::nullopt;
+        }
+        if (rate.value() <= 0) {
+            error("ControlPlaneSmith: The rate of a Poisson process must be positive.");
+            return std::nullopt;
+        }
+        arrivalProcess = ArrivalProcess::poisson(rate.value());
+    } else if (arrivalProcessKind == "onoff") {
+        auto burstSteps = getCount("burstSteps", 1);
+        auto burstDelay = getCount("burstDelayMicroseconds", 0);
+        auto idleDelay =
+            getCount("idleDelayMicroseconds", fuzzerConfig.getMaxUpdateTimeInMicroseconds());
+        if (!burstSteps.has_value() || !burstDelay.has_value() || !idleDelay.has_value()) {
+            return std::nullopt;
+        }
+        if (burstSteps.value() == 0) {
+            error("ControlPlaneSmith: A burst must contain at least one step.");
+            return std::nullopt;
+        }
+        arrivalProcess =
+            ArrivalProcess::onOff(burstSteps.value(), burstDelay.value(), idleDelay.value());
+    } else if (arrivalProcessKind == "ramp") {
+        auto startDelay =
+            getCount("startDelayMicroseconds", fuzzerConfig.getMaxUpdateTimeInMicroseconds());
+        auto endDelay =
+            getCount("endDelayMicroseconds", fuzzerConfig.getMinUpdateTimeInMicroseconds());
+        if (!startDelay.has_value() || !endDelay.has_value()) {
+            return std::nullopt;
+        }
+        arrivalProcess = ArrivalProcess::ramp(startDelay.value(), endDelay.value());
     } else {
-        error("ControlPlaneSmith: The maximum number of updates must be an integer.");
+        error(
+            "ControlPlaneSmith: Unknown arrival process %1%. Expected one of uniform, poisson, "
+            "onoff, and ramp.",
+            arrivalProcessKind.value());
+        return std::nullopt;
     }
 
-    if (const auto maxUpdateTimeInMicrosecondsValueOpt =
-            getAndCastTOMLNode<uint64_t>(tomlConfig, "maxUpdateTimeInMicroseconds")) {
-        fuzzerConfig.setMaxUpdateTimeInMicroseconds(
-            static_cast<uint64_t>(maxUpdateTimeInMicrosecondsValueOpt.value()));
-    } else {
-        error("ControlPlaneSmith: The maximum wait time must be an integer.");
+    auto stepSizeKind = getString("stepSize", "fixed");
+    if (!stepSizeKind.has_value()) {
+        return std::nullopt;
     }
-    if (const auto minUpdateTimeInMicrosecondsValueOpt =
-            getAndCastTOMLNode<uint64_t>(tomlConfig, "minUpdateTimeInMicroseconds")) {
-        fuzzerConfig.setMinUpdateTimeInMicroseconds(
-            static_cast<uint64_t>(minUpdateTimeInMicrosecondsValueOpt.value()));
+    std::optional<StepSize> stepSize;
+    if (stepSizeKind == "fixed") {
+        auto size = getCount("updatesPerStep", fuzzerConfig.getMaxEntryGenCnt());
+        if (!size.has_value()) {
+            return std::nullopt;
+        }
+        stepSize = StepSize::fixed(size.value());
+    } else if (stepSizeKind == "uniform") {
+        auto minSize = getCount("minUpdatesPerStep", 1);
+        auto maxSize = getCount("maxUpdatesPerStep", fuzzerConfig.getMaxEntryGenCnt());
+        if (!minSize.has_value() || !maxSize.has_value()) {
+            return std::nullopt;
+        }
+        if (minSize.value() > maxSize.value()) {
+            error(
+                "ControlPlaneSmith: The minimum step size must not exceed the maximum step "
+                "size.");
+            return std::nullopt;
+        }
+        stepSize = StepSize::uniform(minSize.value(), maxSize.value());
+    } else if (stepSizeKind == "geometric") {
+        auto meanSize = getNumber("meanUpdatesPerStep", fuzzerConfig.getMaxEntryGenCnt());
+        if (!meanSize.has_value()) {
+            return std::nullopt;
+        }
+        if (meanSize.value() < 1) {
+            error("ControlPlaneSmith: The mean step size must be at least 1.");
+            return std::nullopt;
+        }
+        stepSize = StepSize::geometric(meanSize.value());
     } else {
-        error("ControlPlaneSmith: The minimum wait time must be an integer.");
+        error(
+            "ControlPlaneSmith: Unknown step size distribution %1%. Expected one of fixed, "
+            "uniform, and geometric.",
+            stepSizeKind.value());
+        return std::nullopt;
     }
+
+    bool insertOnly = false;
+    if (phaseTable.contains("insertOnly")) {
+        if (auto insertOnlyValue = phaseTable["insertOnly"].value<bool>()) {
+            insertOnly = insertOnlyValue.value();
+        } else {
+            error("ControlPlaneSmith: The workload phase parameter insertOnly must be a boolean.");
+            return std::nullopt;
+        }
+    }
+    return WorkloadPhase{numSteps.value(), arrivalProcess.value(), stepSize.value(), insertOnly};
 }
 
-void TOMLUtils::overrideFuzzerConfigsInString(FuzzerConfig &fuzzerConfig,
-                                              std::string configInString) {
-    toml::parse_result tomlConfig;
-    try {
-        // Note that the parameter fed into the `parse` function should be of (or could be
-        // converted to) type `std::string_view`.
-        tomlConfig = toml::parse(configInString);
-    } catch (const toml::parse_error &e) {
-        error("ControlPlaneSmith: Failed to parse fuzzer configuration string: %1%", e.what());
+std::optional<TablePolicy> TOMLUtils::parseTablePolicy(const toml::table &policyTable,
+                                                       TablePolicy policy) {
+    // @returns false if the policy sets @param key to a value that is not a non-negative integer.
+    // Otherwise, stores the value in @param result.
+    auto getCount = [&policyTable](const char *key, auto &result) {
+        if (!policyTable.contains(key)) {
+            return true;
+        }
+        auto value = policyTable[key].value<int64_t>();
+        if (!value.has_value() || value.value() < 0) {
+            error("ControlPlaneSmith: The table policy parameter %1% must be a non-negative "
+                  "integer.",
+                  key);
+            return false;
+        }
+        result = value.value();
+        return true;
+    };
+    // @returns false if the policy sets @param key to a value that is not a number in [0, @param
+    // max]. Otherwise, stores the value in @param result.
+    auto getNumber = [&policyTable](const char *key, double max, auto &result) {
+        if (!policyTable.contains(key)) {
+            return true;
+        }
+        auto value = policyTable[key].value<double>();
+        if (!value.has_value() || value.value() < 0 || value.value() > max) {
+            if (std::isinf(max)) {
+                error("ControlPlaneSmith: The table policy parameter %1% must be a non-negative "
+                      "number.",
+                      key);
+            } else {
+                error("ControlPlaneSmith: The table policy parameter %1% must be a number in "
+                      "[0, %2%].",
+                      key, max);
+            }
+            return false;
+        }
+        result = value.value();
+        return true;
+    };
+
+    if (policyTable.contains("enabled")) {
+        if (auto enabledValue = policyTable["enabled"].value<bool>()) {
+            policy.enabled = enabledValue.value();
+        } else {
+            error("ControlPlaneSmith: The table policy parameter enabled must be a boolean.");
+            return std::nullopt;
+        }
+    }
+    if (!getCount("entryCount", policy.entryCount) ||
+        !getNumber("fillRatio", 1.0, policy.fillRatio) ||
+        !getCount("insertWeight", policy.insertWeight) ||
+        !getCount("modifyWeight", policy.modifyWeight) ||
+        !getCount("deleteWeight", policy.deleteWeight) ||
+        !getCount("minPrefixLength", policy.minPrefixLength) ||
+        !getCount("maxPrefixLength", policy.maxPrefixLength) ||
+        !getNumber("wildcardProbability", 1.0, policy.wildcardProbability) ||
+        !getNumber("weight", std::numeric_limits<double>::infinity(), policy.weight) ||
+        !getNumber("overlapTarget", std::numeric_limits<double>::infinity(),
+                   policy.overlapTarget)) {
+        return std::nullopt;
+    }
+    if (policy.maxPrefixLength.has_value() &&
+        policy.minPrefixLength > policy.maxPrefixLength.value()) {
+        error(
+            "ControlPlaneSmith: The minimum prefix length must not exceed the maximum prefix "
+            "length.");
+        return std::nullopt;
     }
+    return policy;
+}
 
+void TOMLUtils::overrideFuzzerConfigsImpl(FuzzerConfig &fuzzerConfig,
+                                          const toml::parse_result &tomlConfig) {
     // For the following blocks, retrieve the configurations from the TOML file and override the
     // default configurations if they comply with the constraints.
     // Check if the node exists and can be casted to a pointer to a node representation of an
@@ -151,6 +342,247 @@ void TOMLUtils::overrideFuzzerConfigsInString(FuzzerConfig &fuzzerConfig,
     } else {
         error("ControlPlaneSmith: The minimum wait time must be an integer.");
     }
+
+    // The following configurations are optional. They are only overridden if they are present.
+    if (tomlConfig["overlapTargets"]) {
+        if (const auto overlapTargetsValueOpt =
+                getAndCastTOMLNode<std::map<std::string, double>>(tomlConfig, "overlapTargets")) {
+            fuzzerConfig.setOverlapTargets(overlapTargetsValueOpt.value());
+        } else {
+            error(
+                "ControlPlaneSmith: The overlap targets must be a table mapping table names to "
+                "numbers.");
+        }
+    }
+
+    if (tomlConfig["tableWeighting"]) {
+        if (const auto tableWeightingValueOpt =
+                getAndCastTOMLNode<std::string>(tomlConfig, "tableWeighting")) {
+            fuzzerConfig.setTableWeighting(tableWeightingValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The table weighting must be a string.");
+        }
+    }
+
+    if (tomlConfig["tables"]) {
+        // Table policies refine the overlap targets, so they are parsed afterwards.
+        if (const auto *tablesTable = tomlConfig["tables"].as_table()) {
+            for (const auto &[tableName, policyNode] : *tablesTable) {
+                const auto *policyTable = policyNode.as_table();
+                if (policyTable == nullptr) {
+                    error("ControlPlaneSmith: The policy of table %1% must be a table.",
+                          tableName.str());
+                    continue;
+                }
+                const auto &tablePolicies = fuzzerConfig.getTablePolicies();
+                auto it = tablePolicies.find(std::string(tableName.str()));
+                auto policy = parseTablePolicy(
+                    *policyTable, it == tablePolicies.end() ? TablePolicy() : it->second);
+                if (policy.has_value()) {
+                    fuzzerConfig.setTablePolicy(std::string(tableName.str()), policy.value());
+                }
+            }
+        } else {
+            error("ControlPlaneSmith: The table policies must be a table of tables.");
+        }
+    }
+
+    if (tomlConfig["insertWeight"]) {
+        if (const auto insertWeightValueOpt =
+                getAndCastTOMLNode<uint64_t>(tomlConfig, "insertWeight")) {
+            fuzzerConfig.setInsertWeight(insertWeightValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The insert weight must be an integer.");
+        }
+    }
+    if (tomlConfig["modifyWeight"]) {
+        if (const auto modifyWeightValueOpt =
+                getAndCastTOMLNode<uint64_t>(tomlConfig, "modifyWeight")) {
+            fuzzerConfig.setModifyWeight(modifyWeightValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The modify weight must be an integer.");
+        }
+    }
+    if (tomlConfig["deleteWeight"]) {
+        if (const auto deleteWeightValueOpt =
+                getAndCastTOMLNode<uint64_t>(tomlConfig, "deleteWeight")) {
+            fuzzerConfig.setDeleteWeight(deleteWeightValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The delete weight must be an integer.");
+        }
+    }
+    if (tomlConfig["maxUpdatesPerRequest"]) {
+        if (const auto maxUpdatesPerRequestValueOpt =
+                getAndCastTOMLNode<size_t>(tomlConfig, "maxUpdatesPerRequest")) {
+            fuzzerConfig.setMaxUpdatesPerRequest(maxUpdatesPerRequestValueOpt.value());
+        } else {
+            error(
+                "ControlPlaneSmith: The maximum number of updates per request must be an "
+                "integer.");
+        }
+    }
+    if (tomlConfig["maxBytesPerRequest"]) {
+        if (const auto maxBytesPerRequestValueOpt =
+                getAndCastTOMLNode<size_t>(tomlConfig, "maxBytesPerRequest")) {
+            fuzzerConfig.setMaxBytesPerRequest(maxBytesPerRequestValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum size of a request must be an integer.");
+        }
+    }
+    if (tomlConfig["maxActionProfileMembers"]) {
+        if (const auto maxActionProfileMembersValueOpt =
+                getAndCastTOMLNode<int>(tomlConfig, "maxActionProfileMembers")) {
+            fuzzerConfig.setMaxActionProfileMembers(maxActionProfileMembersValueOpt.value());
+        } else {
+            error(
+                "ControlPlaneSmith: The maximum number of action profile members must be an "
+                "integer.");
+        }
+    }
+    if (tomlConfig["maxSelectorGroups"]) {
+        if (const auto maxSelectorGroupsValueOpt =
+                getAndCastTOMLNode<int>(tomlConfig, "maxSelectorGroups")) {
+            fuzzerConfig.setMaxSelectorGroups(maxSelectorGroupsValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum number of selector groups must be an integer.");
+        }
+    }
+    if (tomlConfig["minGroupSize"]) {
+        if (const auto minGroupSizeValueOpt = getAndCastTOMLNode<int>(tomlConfig, "minGroupSize")) {
+            fuzzerConfig.setMinGroupSize(minGroupSizeValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The minimum group size must be an integer.");
+        }
+    }
+    if (tomlConfig["maxGroupSize"]) {
+        if (const auto maxGroupSizeValueOpt = getAndCastTOMLNode<int>(tomlConfig, "maxGroupSize")) {
+            fuzzerConfig.setMaxGroupSize(maxGroupSizeValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum group size must be an integer.");
+        }
+    }
+    if (tomlConfig["maxMemberWeight"]) {
+        if (const auto maxMemberWeightValueOpt =
+                getAndCastTOMLNode<int>(tomlConfig, "maxMemberWeight")) {
+            fuzzerConfig.setMaxMemberWeight(maxMemberWeightValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum member weight must be an integer.");
+        }
+    }
+    if (tomlConfig["maxMulticastGroups"]) {
+        if (const auto maxMulticastGroupsValueOpt =
+                getAndCastTOMLNode<int>(tomlConfig, "maxMulticastGroups")) {
+            fuzzerConfig.setMaxMulticastGroups(maxMulticastGroupsValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum number of multicast groups must be an integer.");
+        }
+    }
+    if (tomlConfig["maxCloneSessions"]) {
+        if (const auto maxCloneSessionsValueOpt =
+                getAndCastTOMLNode<int>(tomlConfig, "maxCloneSessions")) {
+            fuzzerConfig.setMaxCloneSessions(maxCloneSessionsValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum number of clone sessions must be an integer.");
+        }
+    }
+    if (tomlConfig["minReplicas"]) {
+        if (const auto minReplicasValueOpt = getAndCastTOMLNode<int>(tomlConfig, "minReplicas")) {
+            fuzzerConfig.setMinReplicas(minReplicasValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The minimum number of replicas must be an integer.");
+        }
+    }
+    if (tomlConfig["maxReplicas"]) {
+        if (const auto maxReplicasValueOpt = getAndCastTOMLNode<int>(tomlConfig, "maxReplicas")) {
+            fuzzerConfig.setMaxReplicas(maxReplicasValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The maximum number of replicas must be an integer.");
+        }
+    }
+    if (tomlConfig["readRatio"]) {
+        if (const auto readRatioValueOpt = getAndCastTOMLNode<double>(tomlConfig, "readRatio")) {
+            fuzzerConfig.setReadRatio(readRatioValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The read ratio must be a number.");
+        }
+    }
+    if (tomlConfig["keyPopularity"]) {
+        // The parameters of the popularity models are only used by their model.
+        double zipfExponent = 1.0;
+        double hotKeyFraction = 0.1;
+        double hotKeyProbability = 0.9;
+        if (tomlConfig["zipfExponent"]) {
+            if (const auto zipfExponentValueOpt =
+                    getAndCastTOMLNode<double>(tomlConfig, "zipfExponent")) {
+                zipfExponent = zipfExponentValueOpt.value();
+            } else {
+                error("ControlPlaneSmith: The Zipf exponent must be a number.");
+            }
+        }
+        if (tomlConfig["hotKeyFraction"]) {
+            if (const auto hotKeyFractionValueOpt =
+                    getAndCastTOMLNode<double>(tomlConfig, "hotKeyFraction")) {
+                hotKeyFraction = hotKeyFractionValueOpt.value();
+            } else {
+                error("ControlPlaneSmith: The hot key fraction must be a number.");
+            }
+        }
+        if (tomlConfig["hotKeyProbability"]) {
+            if (const auto hotKeyProbabilityValueOpt =
+                    getAndCastTOMLNode<double>(tomlConfig, "hotKeyProbability")) {
+                hotKeyProbability = hotKeyProbabilityValueOpt.value();
+            } else {
+                error("ControlPlaneSmith: The hot key probability must be a number.");
+            }
+        }
+        if (const auto keyPopularityValueOpt =
+                getAndCastTOMLNode<std::string>(tomlConfig, "keyPopularity")) {
+            fuzzerConfig.setKeyPopularity(keyPopularityValueOpt.value(), zipfExponent,
+                                          hotKeyFraction, hotKeyProbability);
+        } else {
+            error("ControlPlaneSmith: The key popularity must be a string.");
+        }
+    }
+    if (tomlConfig["reinsertProbability"]) {
+        if (const auto reinsertProbabilityValueOpt =
+                getAndCastTOMLNode<double>(tomlConfig, "reinsertProbability")) {
+            fuzzerConfig.setReinsertProbability(reinsertProbabilityValueOpt.value());
+        } else {
+            error("ControlPlaneSmith: The reinsert probability must be a number.");
+        }
+    }
+    if (tomlConfig["workloadPhases"]) {
+        // The phases use the other configurations as defaults, so they are parsed last.
+        if (const auto *phaseArray = tomlConfig["workloadPhases"].as_array()) {
+            std::vector<WorkloadPhase> phases;
+            for (const auto &phaseNode : *phaseArray) {
+                const auto *phaseTable = phaseNode.as_table();
+                if (phaseTable == nullptr) {
+                    error("ControlPlaneSmith: Every workload phase must be a table.");
+                    continue;
+                }
+                if (auto phase = parseWorkloadPhase(*phaseTable, fuzzerConfig)) {
+                    phases.push_back(phase.value());
+                }
+            }
+            fuzzerConfig.setWorkloadPhases(phases);
+        } else {
+            error("ControlPlaneSmith: The workload phases must be an array of tables.");
+        }
+    }
+    if (fuzzerConfig.getMinGroupSize() > fuzzerConfig.getMaxGroupSize()) {
+        error("ControlPlaneSmith: The minimum group size must not exceed the maximum group size.");
+    }
+    if (fuzzerConfig.getMinReplicas() > fuzzerConfig.getMaxReplicas()) {
+        error(
+            "ControlPlaneSmith: The minimum number of replicas must not exceed the maximum number "
+            "of replicas.");
+    }
+    if (fuzzerConfig.getInsertWeight() + fuzzerConfig.getModifyWeight() +
+            fuzzerConfig.getDeleteWeight() ==
+        0) {
+        error("ControlPlaneSmith: At least one of the update weights must be positive.");
+    }
 }
 
 }  // namespace P4::P4Tools::RtSmith
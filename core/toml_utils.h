@@ -3,6 +3,8 @@
 
 #include <toml++/toml.hpp>
 
+#include <map>
+
 #include "backends/p4tools/modules/rtsmith/core/config.h"
 
 namespace P4::P4Tools::RtSmith {
@@ -32,6 +34,24 @@ class TOMLUtils {
         if constexpr (std::is_same_v<T, int> || std::is_same_v<T, uint64_t> ||
                       std::is_same_v<T, size_t>) {
             return castTOMLNode<T>(node);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            return node.template value<std::string>();
+        } else if constexpr (std::is_same_v<T, double>) {
+            // Integers are accepted as well and converted to floating point.
+            return node.template value<double>();
+        } else if constexpr (std::is_same_v<T, std::map<std::string, double>>) {
+            if (const auto *nodeValuePtr = node.as_table()) {
+                std::map<std::string, double> result;
+                for (const auto &[key, element] : *nodeValuePtr) {
+                    // Integers are accepted as well and converted to floating point.
+                    if (const auto elementValue = element.template value<double>()) {
+                        result.emplace(key.str(), elementValue.value());
+                    } else {
+                        return std::nullopt;
+                    }
+                }
+                return std::make_optional(result);
+            }
         } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
             if (auto nodeValuePtr = node.as_array()) {
                 std::vector<std::string> result;
@@ -76,6 +96,27 @@ class TOMLUtils {
         }
         return std::nullopt;
     }
+
+ private:
+    /// @brief Parse a phase of the update series.
+    /// @param phaseTable The TOML table of the phase.
+    /// @param fuzzerConfig Provides the defaults of the phase parameters.
+    /// @return The phase or std::nullopt if the phase is invalid.
+    static std::optional<WorkloadPhase> parseWorkloadPhase(const toml::table &phaseTable,
+                                                           const FuzzerConfig &fuzzerConfig);
+
+    /// @brief Parse the generation policy of a table.
+    /// @param policyTable The TOML table of the policy.
+    /// @param policy Provides the defaults of the policy parameters.
+    /// @return The policy or std::nullopt if the policy is invalid.
+    static std::optional<TablePolicy> parseTablePolicy(const toml::table &policyTable,
+                                                       TablePolicy policy);
+
+    /// @brief Override the default fuzzer configurations with the parsed TOML configurations.
+    /// @param fuzzConfig The fuzzer configurations.
+    /// @param tomlConfig The parsed TOML configurations.
+    static void overrideFuzzerConfigsImpl(FuzzerConfig &fuzzerConfig,
+                                          const toml::parse_result &tomlConfig);
 };
 
 }  // namespace P4::P4Tools::RtSmith
@@ -0,0 +1,108 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_WRITE_REQUEST_BATCHER_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_WRITE_REQUEST_BATCHER_H_
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/coded_stream.h>
+#pragma GCC diagnostic pop
+
+namespace P4::P4Tools::RtSmith {
+
+/// The default maximum encoded size of a write request in bytes. gRPC rejects received messages
+/// above 4 MiB by default. Requests leave 64 KiB of headroom below that limit for the fields a
+/// client sets before sending them, such as the `device_id` and `election_id` the PTF harness
+/// sets, and for the framing of the RPC.
+inline constexpr size_t DEFAULT_MAX_BYTES_PER_REQUEST = 4 * 1024 * 1024 - 64 * 1024;
+
+/// The line that precedes every request in a text format file of several write requests. Text
+/// format parsers skip it as a comment, so the file still parses as one merged request, while
+/// clients that send the requests separately, such as the PTF harness, split the file on it.
+inline constexpr std::string_view WRITE_REQUEST_SEPARATOR = "# write request\n";
+
+/// Packs a stream of updates into write requests that respect a maximum number of updates and a
+/// maximum encoded size per request. Requests are completed as updates are added. The size of a
+/// request is tracked incrementally from the size of each update, so no request is serialized.
+/// Works for any write request message with a repeated `updates` field, i.e., both P4Runtime and
+/// BFRuntime requests.
+template <typename RequestType>
+class WriteRequestBatcher {
+ public:
+    using UpdateType =
+        std::decay_t<decltype(std::declval<const RequestType &>().updates().Get(0))>;
+
+    /// @param maxUpdatesPerRequest The maximum number of updates per request. 0 means unlimited.
+    /// @param maxBytesPerRequest The maximum encoded size of a request in bytes. 0 means unlimited.
+    WriteRequestBatcher(size_t maxUpdatesPerRequest, size_t maxBytesPerRequest)
+        : maxUpdatesPerRequest(maxUpdatesPerRequest), maxBytesPerRequest(maxBytesPerRequest) {}
+
+    /// Append @param update to the request under construction. If the update does not fit into
+    /// that request, the request is completed first and the update starts a new one. An update
+    /// that exceeds the byte limit on its own is put into a request of its own.
+    void add(UpdateType &&update) {
+        auto updateBytes = encodedSize(update.ByteSizeLong());
+        if (current != nullptr &&
+            ((maxUpdatesPerRequest != 0 &&
+              static_cast<size_t>(current->updates_size()) >= maxUpdatesPerRequest) ||
+             (maxBytesPerRequest != 0 && currentBytes + updateBytes > maxBytesPerRequest))) {
+            flush();
+        }
+        if (current == nullptr) {
+            current = std::make_unique<RequestType>();
+        }
+        current->mutable_updates()->Add(std::move(update));
+        currentBytes += updateBytes;
+    }
+
+    /// Complete the request under construction, if any.
+    void flush() {
+        if (current != nullptr) {
+            requests.push_back(std::move(current));
+            currentBytes = 0;
+        }
+    }
+
+    /// @returns the completed requests and hands over their ownership to the caller.
+    [[nodiscard]] std::vector<std::unique_ptr<RequestType>> takeRequests() {
+        return std::exchange(requests, {});
+    }
+
+    /// @returns the number of updates in the request under construction.
+    [[nodiscard]] size_t pendingUpdates() const {
+        return current == nullptr ? 0 : current->updates_size();
+    }
+
+ private:
+    /// The maximum number of updates per request. 0 means unlimited.
+    size_t maxUpdatesPerRequest;
+
+    /// The maximum encoded size of a request in bytes. 0 means unlimited.
+    size_t maxBytesPerRequest;
+
+    /// The request under construction.
+    std::unique_ptr<RequestType> current;
+
+    /// The encoded size of the request under construction.
+    size_t currentBytes = 0;
+
+    /// The completed requests.
+    std::vector<std::unique_ptr<RequestType>> requests;
+
+    /// @returns the number of bytes an update of size @param updateBytes adds to the encoded
+    /// request: The field tag, the length prefix, and the update itself.
+    static size_t encodedSize(size_t updateBytes) {
+        return 1 + google::protobuf::io::CodedOutputStream::VarintSize64(updateBytes) +
+               updateBytes;
+    }
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_CORE_WRITE_REQUEST_BATCHER_H_ */
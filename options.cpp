@@ -1,6 +1,10 @@
 #include "backends/p4tools/modules/rtsmith/options.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <random>
+#include <string_view>
+#include <thread>
 
 #include "backends/p4tools/common/compiler/context.h"
 #include "backends/p4tools/common/lib/logging.h"
@@ -20,6 +24,7 @@ const std::set<std::string> K_SUPPORTED_CONTROL_PLANES = {"P4RUNTIME", "BFRUNTIM
 RtSmithOptions::RtSmithOptions()
     : AbstractP4cToolOptions(RtSmith::TOOL_NAME,
                              "Remove control-plane dead code from a P4 program.") {
+    _shardingPolicy.numThreads = std::max(1U, std::thread::hardware_concurrency());
     registerOption(
         "--print-to-stdout", nullptr,
         [this](const char *) {
@@ -108,6 +113,124 @@ RtSmithOptions::RtSmithOptions()
             return true;
         },
         "Set the fuzzer configurations using the TOML file specified by the file path");
+    registerOption(
+        "--checkpoint-dir", "dirPath",
+        [this](const char *arg) {
+            _checkpointDir = std::filesystem::path(arg);
+            return true;
+        },
+        "Periodically checkpoint the state of the fuzzer in the specified directory, so that a "
+        "long-running generation can be continued with --resume.");
+    registerOption(
+        "--checkpoint-interval", "steps",
+        [this](const char *arg) {
+            char *end = nullptr;
+            auto interval = std::strtoull(arg, &end, 10);
+            if (end == arg || *end != '\0' || interval == 0) {
+                error("--checkpoint-interval must be a positive number of time steps.");
+                return false;
+            }
+            _checkpointInterval = interval;
+            return true;
+        },
+        "The number of time steps between two checkpoint snapshots. Defaults to 100.");
+    registerOption(
+        "--resume", nullptr,
+        [this](const char *) {
+            _resume = true;
+            return true;
+        },
+        "Continue the update series from the checkpoint in the directory set with "
+        "--checkpoint-dir instead of starting from scratch.");
+    registerOption(
+        "--initial-state", "filePath",
+        [this](const char *arg) {
+            _initialState = arg;
+            if (!std::filesystem::exists(_initialState.value())) {
+                error("%1% does not exist. Please provide a valid file path.",
+                      _initialState.value().c_str());
+                return false;
+            }
+            return true;
+        },
+        "Start from the switch state in the specified file instead of an empty switch. The file "
+        "contains a write request or a read response, in text or binary format. The update "
+        "series modifies and deletes the entries of this state.");
+    registerOption(
+        "--initial-state-delta", nullptr,
+        [this](const char *) {
+            _initialStateDelta = true;
+            return true;
+        },
+        "Also fuzz a target state on top of the state set with --initial-state and emit the "
+        "initial configuration as the delta that reaches it. Without this option, the initial "
+        "configuration is empty.");
+    registerOption(
+        "--shard-size", "updates",
+        [this](const char *arg) {
+            char *end = nullptr;
+            auto maxUpdates = std::strtoull(arg, &end, 10);
+            if (end == arg || *end != '\0' || maxUpdates == 0) {
+                error("--shard-size must be a positive number of updates.");
+                return false;
+            }
+            _shardingPolicy.maxUpdates = maxUpdates;
+            return true;
+        },
+        "Split the initial configuration into shards of at most the specified number of updates. "
+        "The shards are written concurrently and listed in a manifest next to the configuration.");
+    registerOption(
+        "--shard-by-table", nullptr,
+        [this](const char *) {
+            _shardingPolicy.byTable = true;
+            return true;
+        },
+        "Split the initial configuration into shards that only contain the updates of a single "
+        "table, so that consumers can load the tables in parallel.");
+    registerOption(
+        "--shard-max-bytes", "bytes",
+        [this](const char *arg) {
+            char *end = nullptr;
+            auto maxBytes = std::strtoull(arg, &end, 10);
+            if (end == arg || *end != '\0' || maxBytes == 0) {
+                error("--shard-max-bytes must be a positive number of bytes.");
+                return false;
+            }
+            _shardingPolicy.maxBytes = maxBytes;
+            return true;
+        },
+        "Continue a shard of the initial configuration in a new file once its file reaches the "
+        "specified size.");
+    registerOption(
+        "--output-jobs", "jobs",
+        [this](const char *arg) {
+            char *end = nullptr;
+            auto numThreads = std::strtoull(arg, &end, 10);
+            if (end == arg || *end != '\0' || numThreads == 0) {
+                error("--output-jobs must be a positive number of threads.");
+                return false;
+            }
+            _shardingPolicy.numThreads = numThreads;
+            return true;
+        },
+        "The number of threads that write the shards of the initial configuration. Defaults to "
+        "the number of hardware threads.");
+    registerOption(
+        "--compress", "algorithm",
+        [this](const char *arg) {
+            if (std::string_view(arg) == "gzip") {
+                _compression = Compression::Gzip;
+            } else if (std::string_view(arg) == "none") {
+                _compression = Compression::None;
+            } else {
+                error("Unsupported compression %1%. Supported are gzip and none.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Compress the initial configuration, the update files, and the checkpoint with the "
+        "specified algorithm (gzip or none). Compressed files get a .gz extension. RtSmith and "
+        "its tools decompress them transparently.");
 }
 
 std::filesystem::path RtSmithOptions::outputDir() const { return _outputDir; }
@@ -117,6 +240,19 @@ bool RtSmithOptions::validateOptions() const {
         error("Both --user-p4info and --generate-p4info are specified. Please specify only one.");
         return false;
     }
+    if (_resume && !_checkpointDir.has_value()) {
+        error("--resume requires --checkpoint-dir.");
+        return false;
+    }
+    if (_resume && _initialState.has_value()) {
+        error("--resume restores the state from the checkpoint, it can not be combined with "
+              "--initial-state.");
+        return false;
+    }
+    if (_initialStateDelta && !_initialState.has_value()) {
+        error("--initial-state-delta requires --initial-state.");
+        return false;
+    }
     if (!seed.has_value()) {
         warning("No seed is set. Will always choose 0 for random values.");
     }
@@ -143,6 +279,24 @@ std::optional<std::string> RtSmithOptions::fuzzerConfigString() const {
     return _fuzzerConfigString;
 }
 
+std::optional<std::filesystem::path> RtSmithOptions::checkpointDir() const {
+    return _checkpointDir;
+}
+
+uint64_t RtSmithOptions::checkpointInterval() const { return _checkpointInterval; }
+
+bool RtSmithOptions::resume() const { return _resume; }
+
+std::optional<std::filesystem::path> RtSmithOptions::initialState() const {
+    return _initialState;
+}
+
+bool RtSmithOptions::initialStateDelta() const { return _initialStateDelta; }
+
+const ShardingPolicy &RtSmithOptions::shardingPolicy() const { return _shardingPolicy; }
+
+Compression RtSmithOptions::compression() const { return _compression; }
+
 void RtSmithOptions::setFuzzerConfigPath(std::string arg) { _fuzzerConfigPath = arg; }
 
 void RtSmithOptions::setFuzzerConfigString(std::string arg) { _fuzzerConfigString = arg; }
@@ -1,10 +1,13 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_OPTIONS_H_
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_OPTIONS_H_
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 
 #include "backends/p4tools/common/options.h"
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+#include "backends/p4tools/modules/rtsmith/core/sharded_writer.h"
 
 namespace P4::P4Tools::RtSmith {
 
@@ -46,6 +49,29 @@ class RtSmithOptions : public AbstractP4cToolOptions {
     /// format TOML.
     [[nodiscard]] std::optional<std::string> fuzzerConfigString() const;
 
+    /// @returns the path set with --checkpoint-dir.
+    [[nodiscard]] std::optional<std::filesystem::path> checkpointDir() const;
+
+    /// @returns the number of time steps between checkpoint snapshots set with
+    /// --checkpoint-interval.
+    [[nodiscard]] uint64_t checkpointInterval() const;
+
+    /// @returns true when the --resume option has been set.
+    [[nodiscard]] bool resume() const;
+
+    /// @returns the path set with --initial-state.
+    [[nodiscard]] std::optional<std::filesystem::path> initialState() const;
+
+    /// @returns true when the --initial-state-delta option has been set.
+    [[nodiscard]] bool initialStateDelta() const;
+
+    /// @returns how the initial configuration is split into shards, set with --shard-size,
+    /// --shard-by-table, --shard-max-bytes, and --output-jobs.
+    [[nodiscard]] const ShardingPolicy &shardingPolicy() const;
+
+    /// @returns the compression of the generated files set with --compress.
+    [[nodiscard]] Compression compression() const;
+
     /// @brief Set the path to the TOML file.
     void setFuzzerConfigPath(std::string arg);
 
@@ -76,6 +102,27 @@ class RtSmithOptions : public AbstractP4cToolOptions {
 
     /// The string representation of the fuzzer configurations.
     std::optional<std::string> _fuzzerConfigString = std::nullopt;
+
+    /// The directory the fuzzer state is checkpointed in.
+    std::optional<std::filesystem::path> _checkpointDir = std::nullopt;
+
+    /// The number of time steps between checkpoint snapshots.
+    uint64_t _checkpointInterval = 100;
+
+    /// Whether to continue from the checkpoint in the checkpoint directory.
+    bool _resume = false;
+
+    /// The switch state dump the fuzzer starts from.
+    std::optional<std::filesystem::path> _initialState = std::nullopt;
+
+    /// Whether to emit the initial configuration as a delta on top of the initial state.
+    bool _initialStateDelta = false;
+
+    /// How the initial configuration is split into shards.
+    ShardingPolicy _shardingPolicy;
+
+    /// The compression of the generated configurations and the checkpoint.
+    Compression _compression = Compression::None;
 };
 
 }  // namespace P4::P4Tools::RtSmith
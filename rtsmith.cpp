@@ -5,12 +5,18 @@
 #include <cstddef>
 #include <cstdlib>
 #include <filesystem>
+#include <optional>
+#include <string>
 
 #include "backends/p4tools/common/compiler/compiler_result.h"
 #include "backends/p4tools/common/lib/logging.h"
 #include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/rtsmith/core/checkpoint.h"
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+#include "backends/p4tools/modules/rtsmith/core/sharded_writer.h"
 #include "backends/p4tools/modules/rtsmith/core/target.h"
 #include "backends/p4tools/modules/rtsmith/core/util.h"
+#include "backends/p4tools/modules/rtsmith/core/write_request_batcher.h"
 #include "backends/p4tools/modules/rtsmith/register.h"
 #include "backends/p4tools/modules/rtsmith/toolname.h"
 #include "control-plane/p4RuntimeSerializer.h"
@@ -27,6 +33,18 @@ void RtSmith::registerTarget() {
 
 namespace {
 
+/// @returns the text format of @param message or std::nullopt if it can not be printed.
+std::optional<std::string> printMessage(const google::protobuf::Message &message) {
+    std::string output;
+    google::protobuf::TextFormat::Printer textPrinter;
+    textPrinter.SetExpandAny(true);
+    if (!textPrinter.PrintToString(message, &output)) {
+        error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
+        return std::nullopt;
+    }
+    return output;
+}
+
 std::optional<RtSmithResult> runRtSmith(const CompilerResult &rtSmithResult,
                                         const RtSmithOptions &rtSmithOptions) {
     const auto *programInfo = RtSmithTarget::produceProgramInfo(rtSmithResult, rtSmithOptions);
@@ -50,24 +68,49 @@ std::optional<RtSmithResult> runRtSmith(const CompilerResult &rtSmithResult,
         p4RuntimeApi.serializeP4InfoTo(outputFile, P4::P4RuntimeFormat::TEXT_PROTOBUF);
     }
 
-    auto &fuzzer = RtSmithTarget::getFuzzer(*programInfo);
+    auto fuzzerPtr = RtSmithTarget::produceFuzzer(*programInfo);
+    auto &fuzzer = *fuzzerPtr;
 
-    auto initialConfig = fuzzer.produceInitialConfig();
-    auto timeSeriesUpdates = fuzzer.produceUpdateTimeSeries();
+    std::optional<Checkpoint> checkpoint;
+    if (rtSmithOptions.checkpointDir().has_value()) {
+        checkpoint.emplace(rtSmithOptions.checkpointDir().value(), rtSmithOptions.seed.value_or(0),
+                           rtSmithOptions.checkpointInterval(), rtSmithOptions.compression());
+        fuzzer.setCheckpoint(&checkpoint.value());
+    }
+
+    InitialConfig initialConfig;
+    if (rtSmithOptions.resume()) {
+        // The initial configuration was emitted by the run that created the checkpoint.
+        if (!fuzzer.restoreFromCheckpoint()) {
+            error("P4RuntimeSmith: Failed to resume from the checkpoint. Exiting");
+            return std::nullopt;
+        }
+        printInfo("Resuming after time step %1%", checkpoint->getPosition().steps);
+    } else {
+        auto initialState = rtSmithOptions.initialState();
+        if (initialState.has_value()) {
+            if (!fuzzer.loadInitialState(initialState.value())) {
+                error("P4RuntimeSmith: Failed to load the initial state. Exiting");
+                return std::nullopt;
+            }
+            printInfo("Loaded the initial state from %1%", initialState.value());
+        }
+        // The loaded state is already installed, only the entries added to it are emitted.
+        if (!initialState.has_value() || rtSmithOptions.initialStateDelta()) {
+            initialConfig = fuzzer.produceInitialConfig();
+        }
+    }
 
     if (rtSmithOptions.printToStdout()) {
         printInfo("Generated initial configuration:");
         for (const auto &writeRequest : initialConfig) {
             printInfo("%1%", writeRequest->DebugString());
         }
-
-        printInfo("Time series updates:");
-        for (const auto &[time, writeRequest] : timeSeriesUpdates) {
-            printInfo("Time %1%:\n%2%", writeRequest->DebugString());
-        }
     }
 
     auto dirPath = rtSmithOptions.outputDir();
+    auto compression = rtSmithOptions.compression();
+    std::filesystem::path initialConfigPath;
     if (!dirPath.empty()) {
         if (!std::filesystem::exists(dirPath)) {
             if (!std::filesystem::create_directory(dirPath)) {
@@ -76,7 +119,7 @@ std::optional<RtSmithResult> runRtSmith(const CompilerResult &rtSmithResult,
             }
         }
 
-        auto initialConfigPath = dirPath;
+        initialConfigPath = dirPath;
         if (rtSmithOptions.configName().has_value()) {
             initialConfigPath = initialConfigPath / rtSmithOptions.configName().value();
             initialConfigPath = initialConfigPath.replace_extension("initial_config");
@@ -85,56 +128,99 @@ std::optional<RtSmithResult> runRtSmith(const CompilerResult &rtSmithResult,
         }
         initialConfigPath = initialConfigPath.replace_extension(".txtpb");
 
-        auto *outputFile = openFile(initialConfigPath, true);
-        if (outputFile == nullptr) {
-            error("P4RuntimeSmith: Config file path doesn't exist. Exiting");
-            return std::nullopt;
-        }
-
-        for (const auto &writeRequest : initialConfig) {
-            std::string output;
-            google::protobuf::TextFormat::Printer textPrinter;
-            textPrinter.SetExpandAny(true);
-            if (!textPrinter.PrintToString(*writeRequest, &output)) {
-                error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
+        // A resumed run keeps the initial configuration of the run that created the checkpoint.
+        // Otherwise, it is written before the checkpoint refers to the state it installs.
+        const auto &shardingPolicy = rtSmithOptions.shardingPolicy();
+        if (!rtSmithOptions.resume() && shardingPolicy.isEnabled()) {
+            auto shardFiles = ShardedConfigWriter(shardingPolicy, compression)
+                                  .write(initialConfig, initialConfigPath);
+            if (!shardFiles.has_value()) {
                 return std::nullopt;
             }
-
-            *outputFile << output;
-            if (!outputFile->good()) {
+            printInfo("Wrote initial configuration in %1% files listed in %2%",
+                      shardFiles.value().size(),
+                      ShardedConfigWriter::getManifestPath(initialConfigPath));
+        } else if (!rtSmithOptions.resume()) {
+            auto outputPath = getCompressedPath(initialConfigPath, compression);
+            CompressedOutputFile outputFile;
+            if (!outputFile.open(outputPath, compression)) {
+                error("P4RuntimeSmith: Config file path doesn't exist. Exiting");
+                return std::nullopt;
+            }
+            // Mark the boundaries of the requests, so that clients can send them one at a time
+            // within the size limit of the batcher.
+            for (const auto &writeRequest : initialConfig) {
+                auto output = printMessage(*writeRequest);
+                if (!output.has_value()) {
+                    return std::nullopt;
+                }
+                if (!outputFile.write(WRITE_REQUEST_SEPARATOR) ||
+                    !outputFile.write(output.value())) {
+                    error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
+                    return std::nullopt;
+                }
+            }
+            if (!outputFile.close()) {
                 error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
                 return std::nullopt;
             }
-            printInfo("Wrote initial configuration to %1%", initialConfigPath);
+            printInfo("Wrote initial configuration to %1%", outputPath);
+        }
+    }
+
+    // Every run starts a new epoch, so that the journal only contains the updates of this run.
+    if (checkpoint.has_value() && !checkpoint->startEpoch(*fuzzer.produceStateSnapshot())) {
+        return std::nullopt;
+    }
+    // Continue the numbering of the update files of the resumed run.
+    auto updateIndex = checkpoint.has_value() ? checkpoint->getPosition().requests : 0;
 
-            outputFile->flush();
+    if (rtSmithOptions.printToStdout()) {
+        printInfo("Time series updates:");
+    }
+    // Every update is written as soon as it is produced. The fuzzer only records a time step in
+    // the checkpoint once all of its updates have been consumed, so a resumed run never skips
+    // updates that were not written.
+    UpdateSeries timeSeriesUpdates;
+    auto failed = false;
+    fuzzer.forEachUpdate([&](uint64_t microseconds, ProtobufMessagePtr writeRequest) {
+        updateIndex++;
+        if (rtSmithOptions.printToStdout()) {
+            printInfo("Time %1%:\n%2%", microseconds, writeRequest->DebugString());
         }
-        for (size_t idx = 0; idx < timeSeriesUpdates.size(); ++idx) {
-            const auto &[microseconds, writeRequest] = timeSeriesUpdates.at(idx);
-            std::string output;
-            google::protobuf::TextFormat::Printer textPrinter;
-            textPrinter.SetExpandAny(true);
-            if (!textPrinter.PrintToString(*writeRequest, &output)) {
-                error(ErrorType::ERR_IO, "Failed to serialize protobuf message to text");
-                return std::nullopt;
+        if (!initialConfigPath.empty()) {
+            auto output = printMessage(*writeRequest);
+            if (!output.has_value()) {
+                failed = true;
+                return false;
             }
+            // Read requests are not configuration updates. Give them a distinct name so that
+            // tools consuming the updates can skip them.
+            auto isReadRequest = writeRequest->GetDescriptor()->name() == "ReadRequest";
             auto updatePath = initialConfigPath;
-            updatePath.replace_filename("update_" + std::to_string(idx + 1));
+            updatePath.replace_filename((isReadRequest ? "read_" : "update_") +
+                                        std::to_string(updateIndex));
             updatePath.replace_extension(".txtpb");
-            auto *updateFile = openFile(updatePath, true);
-            if (updateFile == nullptr) {
+            updatePath = getCompressedPath(updatePath, compression);
+            CompressedOutputFile updateFile;
+            if (!updateFile.open(updatePath, compression)) {
                 error("P4RuntimeSmith: Update file path doesn't exist. Exiting");
-                return std::nullopt;
+                failed = true;
+                return false;
             }
-            *updateFile << output;
-            printInfo("Wrote update to %1%", updatePath);
-            if (!updateFile->good()) {
+            if (!updateFile.write(output.value()) || !updateFile.close()) {
                 error(ErrorType::ERR_IO, "Failed to write text protobuf message to the output");
-                return std::nullopt;
+                failed = true;
+                return false;
             }
-
-            updateFile->flush();
+            printInfo("Wrote update to %1%", updatePath);
         }
+        timeSeriesUpdates.emplace_back(microseconds, std::move(writeRequest));
+        return true;
+    });
+    // The checkpoint reports its own errors.
+    if (failed || errorCount() > 0) {
+        return std::nullopt;
     }
 
     return {{std::move(initialConfig), std::move(timeSeriesUpdates)}};
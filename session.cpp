@@ -0,0 +1,53 @@
+#include "backends/p4tools/modules/rtsmith/session.h"
+
+#include <utility>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "backends/p4tools/modules/rtsmith/core/target.h"
+#include "backends/p4tools/modules/rtsmith/rtsmith.h"
+#include "lib/error.h"
+
+namespace P4::P4Tools::RtSmith {
+
+RtSmithSession::RtSmithSession(std::unique_ptr<const CompilerResult> compilerResult,
+                               std::unique_ptr<const ProgramInfo> programInfo)
+    : compilerResult(std::move(compilerResult)),
+      programInfo(std::move(programInfo)),
+      fuzzer(RtSmithTarget::produceFuzzer(*this->programInfo)) {}
+
+std::optional<RtSmithSession> RtSmithSession::create(
+    std::optional<std::reference_wrapper<const std::string>> program,
+    const RtSmithOptions &rtSmithOptions) {
+    auto compilerResultOpt = RtSmith::generateCompilerResult(program, rtSmithOptions);
+    if (!compilerResultOpt.has_value()) {
+        return std::nullopt;
+    }
+    // The program info refers to the compiler result, so it needs a stable address.
+    auto compilerResult = std::make_unique<const CompilerResult>(compilerResultOpt.value());
+    auto programInfo = RtSmithTarget::produceProgramInfo(*compilerResult, rtSmithOptions);
+    if (programInfo == nullptr || errorCount() > 0) {
+        error("P4RuntimeSmith: Program not supported by target device and architecture.");
+        return std::nullopt;
+    }
+    return RtSmithSession(std::move(compilerResult), std::move(programInfo));
+}
+
+void RtSmithSession::reset(uint32_t seed) {
+    Utils::setRandomSeed(static_cast<int>(seed));
+    // A new fuzzer starts with an empty state and a new update series.
+    fuzzer = RtSmithTarget::produceFuzzer(*programInfo);
+}
+
+InitialConfig RtSmithSession::initialConfig() { return fuzzer->produceInitialConfig(); }
+
+UpdateSeries RtSmithSession::nextUpdates(size_t numSteps) {
+    return fuzzer->produceUpdateSteps(numSteps);
+}
+
+std::optional<TimedUpdate> RtSmithSession::nextUpdate() { return fuzzer->nextUpdate(); }
+
+const ProgramInfo &RtSmithSession::getProgramInfo() const { return *programInfo; }
+
+RuntimeFuzzer &RtSmithSession::getFuzzer() { return *fuzzer; }
+
+}  // namespace P4::P4Tools::RtSmith
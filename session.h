@@ -0,0 +1,79 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_SESSION_H_
+#define BACKENDS_P4TOOLS_MODULES_RTSMITH_SESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "backends/p4tools/common/compiler/compiler_result.h"
+#include "backends/p4tools/modules/rtsmith/core/fuzzer.h"
+#include "backends/p4tools/modules/rtsmith/core/program_info.h"
+#include "backends/p4tools/modules/rtsmith/options.h"
+
+namespace P4::P4Tools::RtSmith {
+
+/// Generates configurations for a P4 program that is compiled only once. The session owns the
+/// compiler result, the program info, and the fuzzer, so that embedding applications can generate
+/// many configurations for the same program without recompiling it and without leaking.
+class RtSmithSession {
+ private:
+    /// The compiled program. The program info refers to it.
+    std::unique_ptr<const CompilerResult> compilerResult;
+
+    /// The program info of the target. The fuzzer refers to it.
+    std::unique_ptr<const ProgramInfo> programInfo;
+
+    /// The fuzzer, replaced on every reset.
+    std::unique_ptr<RuntimeFuzzer> fuzzer;
+
+    RtSmithSession(std::unique_ptr<const CompilerResult> compilerResult,
+                   std::unique_ptr<const ProgramInfo> programInfo);
+
+ public:
+    /// @brief Compile a program for the target and architecture set in @param rtSmithOptions.
+    /// @param program The source of the program. If std::nullopt, the file set in the options is
+    /// compiled.
+    /// @return The session or std::nullopt if the program can not be compiled or is not supported
+    /// by the target.
+    static std::optional<RtSmithSession> create(
+        std::optional<std::reference_wrapper<const std::string>> program,
+        const RtSmithOptions &rtSmithOptions);
+
+    RtSmithSession(RtSmithSession &&) = default;
+    RtSmithSession &operator=(RtSmithSession &&) = default;
+    RtSmithSession(const RtSmithSession &) = delete;
+    RtSmithSession &operator=(const RtSmithSession &) = delete;
+    ~RtSmithSession() = default;
+
+    /// @brief Discard all generated state and reseed the random number generator with @param
+    /// seed. Generation after resets with the same seed produces the same configurations.
+    void reset(uint32_t seed);
+
+    /// @brief Produce the initial configuration. Call it once after a reset, before the updates.
+    /// @return An `InitialConfig`.
+    InitialConfig initialConfig();
+
+    /// @brief Produce the next time steps of the update series. Successive calls continue the
+    /// series.
+    /// @param numSteps The maximum number of time steps to produce.
+    /// @return The requests of the time steps, empty if the series has ended.
+    UpdateSeries nextUpdates(size_t numSteps);
+
+    /// @brief Pull the next request of the update series. Only the requests of the current time
+    /// step are held in memory.
+    /// @return The request and its delay or std::nullopt if the series has ended.
+    std::optional<TimedUpdate> nextUpdate();
+
+    /// @returns the program info of the compiled program.
+    [[nodiscard]] const ProgramInfo &getProgramInfo() const;
+
+    /// @returns the fuzzer of the session.
+    [[nodiscard]] RuntimeFuzzer &getFuzzer();
+};
+
+}  // namespace P4::P4Tools::RtSmith
+
+#endif /* BACKENDS_P4TOOLS_MODULES_RTSMITH_SESSION_H_ */
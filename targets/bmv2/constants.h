@@ -31,6 +31,9 @@ class V1ModelConstants {
     /// Details: https://github.com/p4lang/PI/pull/588
     static constexpr uint16_t CLONE_SESSION_ID_MIN = 1;
     static constexpr uint16_t CLONE_SESSION_ID_MAX = 32767;
+    /// BMv2 multicast group ids are 16 bits wide. Group 0 means no multicast.
+    static constexpr uint16_t MULTICAST_GROUP_ID_MIN = 1;
+    static constexpr uint16_t MULTICAST_GROUP_ID_MAX = 65535;
     /// Clone type is derived from v1model.p4
     enum CloneType { I2E = 0, E2E = 1 };
     /// Meter colors are defined in v1model.p4
@@ -1,5 +1,10 @@
 #include "backends/p4tools/modules/rtsmith/targets/bmv2/fuzzer.h"
 
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
 #include "backends/p4tools/common/lib/util.h"
 #include "backends/p4tools/modules/rtsmith/core/fuzzer.h"
 
@@ -12,28 +17,219 @@ const Bmv2V1ModelProgramInfo &Bmv2V1ModelFuzzer::getProgramInfo() const {
     return *P4RuntimeFuzzer::getProgramInfo().checkedTo<Bmv2V1ModelProgramInfo>();
 }
 
-InitialConfig Bmv2V1ModelFuzzer::produceInitialConfig() {
-    InitialConfig initialConfig;
-    initialConfig.push_back(produceWriteRequest(true));
-    return initialConfig;
+namespace {
+
+/// Helpers to treat multicast groups and clone sessions alike.
+uint32_t getReplicationEntryId(const p4::v1::MulticastGroupEntry &entry) {
+    return entry.multicast_group_id();
+}
+
+uint32_t getReplicationEntryId(const p4::v1::CloneSessionEntry &entry) {
+    return entry.session_id();
+}
+
+void setReplicationEntity(p4::v1::Update &update, const p4::v1::MulticastGroupEntry &entry) {
+    *update.mutable_entity()
+         ->mutable_packet_replication_engine_entry()
+         ->mutable_multicast_group_entry() = entry;
+}
+
+void setReplicationEntity(p4::v1::Update &update, const p4::v1::CloneSessionEntry &entry) {
+    *update.mutable_entity()
+         ->mutable_packet_replication_engine_entry()
+         ->mutable_clone_session_entry() = entry;
+}
+
+}  // namespace
+
+std::vector<p4::v1::Replica> Bmv2V1ModelFuzzer::produceReplicas() {
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    auto numReplicas = static_cast<size_t>(
+        Utils::getRandInt(fuzzerConfig.getMinReplicas(), fuzzerConfig.getMaxReplicas()));
+    // Replicas are unique per egress port. Ports range from 0 to the drop port (exclusive).
+    auto numPorts = static_cast<size_t>(V1ModelConstants::DROP_PORT);
+    std::vector<p4::v1::Replica> replicas;
+    for (auto port : sampleDistinctIds(std::min(numReplicas, numPorts), numPorts)) {
+        p4::v1::Replica replica;
+        replica.set_egress_port(port - 1);
+        replicas.push_back(replica);
+    }
+    return replicas;
+}
+
+void Bmv2V1ModelFuzzer::churnReplicas(
+    google::protobuf::RepeatedPtrField<p4::v1::Replica> &replicas) {
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    auto numReplicas = replicas.size();
+    bool canGrow = numReplicas < fuzzerConfig.getMaxReplicas() &&
+                   numReplicas < V1ModelConstants::DROP_PORT;
+    bool canShrink = numReplicas > fuzzerConfig.getMinReplicas();
+    if (canGrow && (!canShrink || Utils::getRandInt(0, 1) == 0)) {
+        // Add a replica to a port that does not receive a replica yet.
+        uint32_t port = 0;
+        do {
+            port = Utils::getRandInt(V1ModelConstants::DROP_PORT - 1);
+        } while (std::any_of(replicas.begin(), replicas.end(),
+                             [port](const p4::v1::Replica &replica) {
+                                 return replica.egress_port() == port;
+                             }));
+        replicas.Add()->set_egress_port(port);
+    } else if (canShrink) {
+        replicas.erase(replicas.begin() + Utils::getRandInt(replicas.size() - 1));
+    }
+}
+
+p4::v1::MulticastGroupEntry Bmv2V1ModelFuzzer::produceMulticastGroupEntry(uint32_t groupId) {
+    p4::v1::MulticastGroupEntry protoEntry;
+    protoEntry.set_multicast_group_id(groupId);
+    for (auto &replica : produceReplicas()) {
+        *protoEntry.add_replicas() = std::move(replica);
+    }
+    return protoEntry;
+}
+
+p4::v1::CloneSessionEntry Bmv2V1ModelFuzzer::produceCloneSessionEntry(uint32_t sessionId) {
+    p4::v1::CloneSessionEntry protoEntry;
+    protoEntry.set_session_id(sessionId);
+    for (auto &replica : produceReplicas()) {
+        *protoEntry.add_replicas() = std::move(replica);
+    }
+    return protoEntry;
+}
+
+template <typename EntryType>
+void Bmv2V1ModelFuzzer::produceReplicationEntryUpdate(
+    TableState<EntryType> &state, uint32_t &nextId, uint32_t maxId, size_t maxEntries,
+    WriteRequestBatcher<p4::v1::WriteRequest> &batcher) {
+    p4::v1::Update update;
+    auto operation = pickUpdateOperation(!state.empty());
+    if (operation == UpdateOperation::Insert && state.size() < maxEntries && nextId <= maxId) {
+        auto id = nextId++;
+        EntryType entry;
+        if constexpr (std::is_same_v<EntryType, p4::v1::MulticastGroupEntry>) {
+            entry = produceMulticastGroupEntry(id);
+        } else {
+            entry = produceCloneSessionEntry(id);
+        }
+        update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+        setReplicationEntity(update, entry);
+        state.insert(std::to_string(id), std::move(entry));
+    } else if (state.empty()) {
+        return;
+    } else if (operation == UpdateOperation::Delete) {
+        auto position = state.samplePosition();
+        update.set_type(p4::v1::Update_Type::Update_Type_DELETE);
+        setReplicationEntity(update, state.entryAt(position));
+        state.erase(std::to_string(getReplicationEntryId(state.entryAt(position))));
+    } else {
+        auto &entry = state.entryAt(state.samplePosition());
+        churnReplicas(*entry.mutable_replicas());
+        update.set_type(p4::v1::Update_Type::Update_Type_MODIFY);
+        setReplicationEntity(update, entry);
+    }
+    batcher.add(std::move(update));
+}
+
+void Bmv2V1ModelFuzzer::producePacketReplicationUpdates(
+    bool isInitialConfig, WriteRequestBatcher<p4::v1::WriteRequest> &batcher) {
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    auto maxMulticastGroups = static_cast<size_t>(fuzzerConfig.getMaxMulticastGroups());
+    auto maxCloneSessions = static_cast<size_t>(fuzzerConfig.getMaxCloneSessions());
+    if (isInitialConfig) {
+        while (multicastGroups.size() < maxMulticastGroups &&
+               nextMulticastGroupId <= V1ModelConstants::MULTICAST_GROUP_ID_MAX) {
+            auto groupId = nextMulticastGroupId++;
+            auto entry = produceMulticastGroupEntry(groupId);
+            p4::v1::Update update;
+            update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+            setReplicationEntity(update, entry);
+            batcher.add(std::move(update));
+            multicastGroups.insert(std::to_string(groupId), std::move(entry));
+        }
+        while (cloneSessions.size() < maxCloneSessions &&
+               nextCloneSessionId <= V1ModelConstants::CLONE_SESSION_ID_MAX) {
+            auto sessionId = nextCloneSessionId++;
+            auto entry = produceCloneSessionEntry(sessionId);
+            p4::v1::Update update;
+            update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+            setReplicationEntity(update, entry);
+            batcher.add(std::move(update));
+            cloneSessions.insert(std::to_string(sessionId), std::move(entry));
+        }
+        return;
+    }
+    // NOTE: Use a coin to decide whether to touch each kind of object in this time step.
+    if (maxMulticastGroups > 0 && Utils::getRandInt(0, 1) == 1) {
+        produceReplicationEntryUpdate(multicastGroups, nextMulticastGroupId,
+                                      V1ModelConstants::MULTICAST_GROUP_ID_MAX,
+                                      maxMulticastGroups, batcher);
+    }
+    if (maxCloneSessions > 0 && Utils::getRandInt(0, 1) == 1) {
+        produceReplicationEntryUpdate(cloneSessions, nextCloneSessionId,
+                                      V1ModelConstants::CLONE_SESSION_ID_MAX, maxCloneSessions,
+                                      batcher);
+    }
 }
 
-UpdateSeries Bmv2V1ModelFuzzer::produceUpdateTimeSeries() {
-    UpdateSeries updateSeries;
-    size_t maxUpdateCount = getProgramInfo().getFuzzerConfig().getMaxUpdateCount();
-    size_t updateCount = Utils::getRandInt(maxUpdateCount);
+ProtobufMessagePtr Bmv2V1ModelFuzzer::produceStateSnapshot() const {
+    auto snapshot = P4RuntimeFuzzer::produceStateSnapshot();
+    auto &request = static_cast<p4::v1::WriteRequest &>(*snapshot);
+    auto addInsertions = [&request](const auto &state) {
+        for (size_t position = 0; position < state.size(); ++position) {
+            auto *update = request.add_updates();
+            update->set_type(p4::v1::Update_Type::Update_Type_INSERT);
+            setReplicationEntity(*update, state.entryAt(position));
+        }
+    };
+    addInsertions(multicastGroups);
+    addInsertions(cloneSessions);
+    return snapshot;
+}
 
-    for (size_t idx = 0; idx < updateCount; ++idx) {
-        auto minUpdateTimeInMicroseconds =
-            getProgramInfo().getFuzzerConfig().getMinUpdateTimeInMicroseconds();
-        auto maxUpdateTimeInMicroseconds =
-            getProgramInfo().getFuzzerConfig().getMaxUpdateTimeInMicroseconds();
-        auto microseconds =
-            Utils::getRandInt(minUpdateTimeInMicroseconds, maxUpdateTimeInMicroseconds);
-        updateSeries.emplace_back(microseconds, produceWriteRequest(false));
+bool Bmv2V1ModelFuzzer::applyUpdate(const p4::v1::Update &update) {
+    if (!update.entity().has_packet_replication_engine_entry()) {
+        return P4RuntimeFuzzer::applyUpdate(update);
+    }
+    auto isDelete = update.type() == p4::v1::Update_Type::Update_Type_DELETE;
+    // Ids are not reused, so the next id follows the largest id seen so far.
+    auto apply = [isDelete](auto &state, uint32_t &nextId, const auto &entry) {
+        auto id = getReplicationEntryId(entry);
+        auto key = std::to_string(id);
+        if (isDelete) {
+            state.erase(key);
+        } else if (auto *installed = state.find(key)) {
+            *installed = entry;
+        } else {
+            state.insert(key, entry);
+        }
+        nextId = std::max(nextId, id + 1);
+    };
+    const auto &replicationEntry = update.entity().packet_replication_engine_entry();
+    if (replicationEntry.has_multicast_group_entry()) {
+        apply(multicastGroups, nextMulticastGroupId, replicationEntry.multicast_group_entry());
+    } else if (replicationEntry.has_clone_session_entry()) {
+        apply(cloneSessions, nextCloneSessionId, replicationEntry.clone_session_entry());
     }
+    return true;
+}
+
+InitialConfig Bmv2V1ModelFuzzer::produceInitialConfig() {
+    return produceBatchedInitialConfig<p4::v1::WriteRequest>([this](auto &batcher) {
+        producePacketReplicationUpdates(true, batcher);
+        produceUpdates(true, batcher, getProgramInfo().getFuzzerConfig().getMaxEntryGenCnt());
+        produceResourceUpdates(true, batcher);
+    });
+}
 
-    return updateSeries;
+UpdateSeries Bmv2V1ModelFuzzer::produceUpdateSteps(size_t maxSteps) {
+    return produceBatchedUpdateSteps<p4::v1::WriteRequest>(
+        maxSteps,
+        [this](auto &batcher, bool insertOnly, uint64_t maxUpdatesPerTable) {
+            producePacketReplicationUpdates(false, batcher);
+            produceUpdates(false, batcher, maxUpdatesPerTable, insertOnly);
+            produceResourceUpdates(false, batcher);
+        },
+        [this]() { return produceReadRequest(); });
 }
 
 }  // namespace P4::P4Tools::RtSmith::V1Model
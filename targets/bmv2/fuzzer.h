@@ -2,6 +2,7 @@
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_TARGETS_BMV2_FUZZER_H_
 
 #include "backends/p4tools/modules/rtsmith/core/fuzzer.h"
+#include "backends/p4tools/modules/rtsmith/targets/bmv2/constants.h"
 #include "backends/p4tools/modules/rtsmith/targets/bmv2/program_info.h"
 
 namespace P4::P4Tools::RtSmith::V1Model {
@@ -11,12 +12,65 @@ class Bmv2V1ModelFuzzer : public P4RuntimeFuzzer {
     /// @returns the program info associated with the current target.
     [[nodiscard]] const Bmv2V1ModelProgramInfo &getProgramInfo() const override;
 
+    /// The multicast groups and clone sessions currently installed in the packet replication
+    /// engine, keyed by their id.
+    TableState<p4::v1::MulticastGroupEntry> multicastGroups;
+    TableState<p4::v1::CloneSessionEntry> cloneSessions;
+
+    /// The next unused multicast group and clone session id. Ids are not reused.
+    uint32_t nextMulticastGroupId = V1ModelConstants::MULTICAST_GROUP_ID_MIN;
+    uint32_t nextCloneSessionId = V1ModelConstants::CLONE_SESSION_ID_MIN;
+
+    /// Produce one update for a packet replication engine object and add it to @param batcher.
+    /// @param state The installed objects of this kind.
+    /// @param nextId The next unused id of this kind.
+    /// @param maxId The largest valid id of this kind.
+    /// @param maxEntries The maximum number of installed objects of this kind.
+    template <typename EntryType>
+    void produceReplicationEntryUpdate(TableState<EntryType> &state, uint32_t &nextId,
+                                       uint32_t maxId, size_t maxEntries,
+                                       WriteRequestBatcher<p4::v1::WriteRequest> &batcher);
+
  public:
     explicit Bmv2V1ModelFuzzer(const Bmv2V1ModelProgramInfo &programInfo);
 
+    /// @brief Produce replicas to distinct egress ports. The number of replicas is drawn from the
+    /// configured replica range.
+    /// @return The replicas.
+    virtual std::vector<p4::v1::Replica> produceReplicas();
+
+    /// @brief Add a replica to or remove a replica from `replicas`, keeping their number within
+    /// the configured replica range.
+    /// @param replicas
+    void churnReplicas(google::protobuf::RepeatedPtrField<p4::v1::Replica> &replicas);
+
+    /// @brief Produce a `MulticastGroupEntry` with random replicas.
+    /// @param groupId
+    /// @return A `MulticastGroupEntry`.
+    p4::v1::MulticastGroupEntry produceMulticastGroupEntry(uint32_t groupId);
+
+    /// @brief Produce a `CloneSessionEntry` with random replicas.
+    /// @param sessionId
+    /// @return A `CloneSessionEntry`.
+    p4::v1::CloneSessionEntry produceCloneSessionEntry(uint32_t sessionId);
+
+    /// @brief Produce the multicast group and clone session updates of a single time step and add
+    /// them to `batcher`.
+    /// @param isInitialConfig The initial configuration installs multicast groups and clone
+    /// sessions. Updates insert, delete, or add and remove replicas of existing ones.
+    /// @param batcher Packs the updates into `WriteRequest`s.
+    void producePacketReplicationUpdates(bool isInitialConfig,
+                                         WriteRequestBatcher<p4::v1::WriteRequest> &batcher);
+
+    /// Extends the snapshot with the installed multicast groups and clone sessions.
+    [[nodiscard]] ProtobufMessagePtr produceStateSnapshot() const override;
+
+    /// Also tracks multicast groups and clone sessions.
+    bool applyUpdate(const p4::v1::Update &update) override;
+
     InitialConfig produceInitialConfig() override;
 
-    UpdateSeries produceUpdateTimeSeries() override;
+    UpdateSeries produceUpdateSteps(size_t maxSteps) override;
 };
 
 }  // namespace P4::P4Tools::RtSmith::V1Model
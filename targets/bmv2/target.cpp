@@ -26,10 +26,10 @@ MidEnd Bmv2V1ModelRtSmithTarget::mkMidEnd(const CompilerOptions &options) const
     return midEnd;
 }
 
-const ProgramInfo *Bmv2V1ModelRtSmithTarget::produceProgramInfoImpl(
+std::unique_ptr<ProgramInfo> Bmv2V1ModelRtSmithTarget::produceProgramInfoImpl(
     const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions,
     const IR::Declaration_Instance * /*mainDecl*/) const {
-    auto bmv2V1ModelProgramInfo = new Bmv2V1ModelProgramInfo(compilerResult);
+    auto bmv2V1ModelProgramInfo = std::make_unique<Bmv2V1ModelProgramInfo>(compilerResult);
     // Override the fuzzer configurations if a TOML file is provided.
     if (rtSmithOptions.fuzzerConfigPath().has_value())
         bmv2V1ModelProgramInfo->loadFuzzerConfig(rtSmithOptions.fuzzerConfigPath().value());
@@ -42,8 +42,9 @@ const ProgramInfo *Bmv2V1ModelRtSmithTarget::produceProgramInfoImpl(
     return bmv2V1ModelProgramInfo;
 }
 
-Bmv2V1ModelFuzzer &Bmv2V1ModelRtSmithTarget::getFuzzerImpl(const ProgramInfo &programInfo) const {
-    return *new Bmv2V1ModelFuzzer(*programInfo.checkedTo<Bmv2V1ModelProgramInfo>());
+std::unique_ptr<RuntimeFuzzer> Bmv2V1ModelRtSmithTarget::produceFuzzerImpl(
+    const ProgramInfo &programInfo) const {
+    return std::make_unique<Bmv2V1ModelFuzzer>(*programInfo.checkedTo<Bmv2V1ModelProgramInfo>());
 }
 
 }  // namespace P4::P4Tools::RtSmith::V1Model
@@ -13,6 +13,9 @@ from ptf.mask import Mask
 from tools import testutils
 from tools.ptf import base_test as bt
 
+# Precedes every write request in a file of several requests, see core/write_request_batcher.h.
+WRITE_REQUEST_SEPARATOR = "# write request\n"
+
 
 class AbstractTest(bt.P4RuntimeTest):
     @bt.autocleanup
@@ -32,26 +35,63 @@ class AbstractTest(bt.P4RuntimeTest):
         req.device_id = self.device_id
         return req
 
-    def setupCtrlPlane(self):
-        initial_config_path = ptfutils.test_param_get("initial_config_file")
-        assert initial_config_path is not None
-        req = self.createWriteRequest()
+    def getInitialConfigPaths(self) -> List[str]:
+        """Returns the initial configs to test, either a single file or a file listing them."""
+        config_list_path = ptfutils.test_param_get("initial_config_list")
+        if config_list_path is None:
+            initial_config_path = ptfutils.test_param_get("initial_config_file")
+            assert initial_config_path is not None
+            return [initial_config_path]
+        with open(config_list_path, "r", encoding="utf-8") as config_list_file:
+            return [line.strip() for line in config_list_file if line.strip()]
+
+    def setupCtrlPlane(self, initial_config_path: str) -> None:
+        """Sends the write requests of the initial config one at a time. RtSmith precedes every
+        request with WRITE_REQUEST_SEPARATOR, so that no request exceeds the gRPC message limit.
+        Files without separators are sent as a single request."""
         with open(initial_config_path, "r", encoding="utf-8") as initial_config_file:
-            google.protobuf.text_format.Merge(
-                initial_config_file.read(), req, allow_unknown_field=True
-            )
-        testutils.log.info("Initial configuration %s", req)
-        return self.write_request(req)
+            requests = initial_config_file.read().split(WRITE_REQUEST_SEPARATOR)
+        for request in requests:
+            if not request.strip() and len(requests) > 1:
+                continue
+            req = self.createWriteRequest()
+            google.protobuf.text_format.Merge(request, req, allow_unknown_field=True)
+            testutils.log.info("Initial configuration %s", req)
+            self.write_request(req)
 
     def sendCtrlPlaneUpdate(self) -> None:
         pass
 
     def runTestImpl(self) -> None:
-        testutils.log.info("Configuring control plane...")
-        self.setupCtrlPlane()
+        initial_config_paths = self.getInitialConfigPaths()
+        if len(initial_config_paths) == 1:
+            testutils.log.info("Configuring control plane...")
+            self.setupCtrlPlane(initial_config_paths[0])
+
+            testutils.log.info("Sending control plane updates...")
+            self.sendCtrlPlaneUpdate()
+            return
+
+        failed_paths = []
+        for index, initial_config_path in enumerate(initial_config_paths):
+            if index > 0:
+                # Pushing the pipeline again clears the state left by the previous config, which
+                # is much cheaper than restarting the switch.
+                assert bt.P4RuntimeTest.updateConfig(self)
+                self.reqs = []
+            testutils.log.info("Configuring control plane with %s...", initial_config_path)
+            try:
+                self.setupCtrlPlane(initial_config_path)
 
-        testutils.log.info("Sending control plane updates...")
-        self.sendCtrlPlaneUpdate()
+                testutils.log.info("Sending control plane updates...")
+                self.sendCtrlPlaneUpdate()
+            except Exception as e:  # pylint: disable=broad-except
+                testutils.log.error("Config %s failed: %s", initial_config_path, e)
+                failed_paths.append(initial_config_path)
+        assert not failed_paths, (
+            f"{len(failed_paths)} of {len(initial_config_paths)} configs failed: "
+            f"{', '.join(failed_paths)}"
+        )
 
 
 class SetUpControlPlaneTest(AbstractTest):
@@ -1,15 +1,18 @@
 #!/usr/bin/env python3
 
 import argparse
+import hashlib
 import logging
 import os
 import random
+import shutil
 import sys
 import tempfile
 import time
 import uuid
 from datetime import datetime
 from pathlib import Path
+from typing import List
 
 PARSER = argparse.ArgumentParser()
 PARSER.add_argument(
@@ -22,7 +25,16 @@ PARSER.add_argument(
     "-tf",
     "--testfile",
     dest="testfile",
-    help="The path for the .txtpb file for this test.",
+    nargs="+",
+    help="The path for the .txtpb file for this test. If several files are given, they are all "
+    "tested against a single switch instance, which is reset between them.",
+)
+PARSER.add_argument(
+    "--cache-dir",
+    default=None,
+    dest="cache_dir",
+    help="A directory in which the compiled program is cached by the hash of the program. "
+    "Files included by the program are not part of the hash.",
 )
 PARSER.add_argument(
     "-td",
@@ -44,6 +56,22 @@ PARSER.add_argument(
     dest="interface_count",
     help="How many virtual interfaces to create.",
 )
+PARSER.add_argument(
+    "--grpc-port",
+    default=None,
+    type=int,
+    dest="grpc_port",
+    help="The first port to try for the P4Runtime server of the switch. Concurrent tests should "
+    "use distinct ports.",
+)
+PARSER.add_argument(
+    "--thrift-port",
+    default=None,
+    type=int,
+    dest="thrift_port",
+    help="The first port to try for the Thrift server of the switch. Concurrent tests should use "
+    "distinct ports.",
+)
 PARSER.add_argument(
     "-ll",
     "--log_level",
@@ -75,14 +103,20 @@ class Options:
 
     # File that is being compiled.
     p4_file: Path = Path(".")
-    # Path to .txtpb test file that is used.
-    testfile: Path = Path(".")
+    # Paths to the .txtpb test files that are used.
+    testfiles: List[Path] = []
+    # Directory that caches compiled programs. No caching if not set.
+    cache_dir: testutils.Optional[Path] = None
     # Actual location of the test framework.
     testdir: Path = Path(".")
     # The base directory where tests are executed.
     rootdir: Path = Path(".")
     # The number of interfaces to create for this particular test.
     interface_count: int = 8
+    # The first port to try for the P4Runtime server of the switch.
+    grpc_port: int = P4RUNTIME_PORT
+    # The first port to try for the Thrift server of the switch.
+    thrift_port: int = THRIFT_PORT
 
 
 class ProtobufTestEnv:
@@ -117,7 +151,19 @@ class ProtobufTestEnv:
         return bridge
 
     def compile_program(self, json_name: Path, info_name: Path) -> int:
-        """Compile the input P4 program using p4c-bm2-ss."""
+        """Compile the input P4 program using p4c-bm2-ss. Reuse the cached artifacts if the
+        program was compiled before."""
+        cache_entry = None
+        if self.options.cache_dir:
+            program_hash = hashlib.sha256(self.options.p4_file.read_bytes()).hexdigest()
+            cache_entry = self.options.cache_dir.joinpath(program_hash)
+            cached_json = cache_entry.with_suffix(".json")
+            cached_info = cache_entry.with_suffix(".p4info.txtpb")
+            if cached_json.exists() and cached_info.exists():
+                testutils.log.info("Using the compiled program cached at %s.", cache_entry)
+                shutil.copyfile(cached_json, json_name)
+                shutil.copyfile(cached_info, info_name)
+                return testutils.SUCCESS
         testutils.log.info("---------------------- Compile with p4c-bm2-ss ----------------------")
         compilation_cmd = (
             f"{self.options.rootdir}/build/p4c-bm2-ss --target bmv2 --arch v1model "
@@ -126,6 +172,14 @@ class ProtobufTestEnv:
         _, returncode = testutils.exec_process(compilation_cmd, timeout=30)
         if returncode != testutils.SUCCESS:
             testutils.log.error("Failed to compile the P4 program %s.", self.options.p4_file)
+            return returncode
+        if cache_entry:
+            self.options.cache_dir.mkdir(parents=True, exist_ok=True)
+            # Copy, then rename, so that concurrent tests never read a partially written entry.
+            for artifact, suffix in ((json_name, ".json"), (info_name, ".p4info.txtpb")):
+                staging = cache_entry.with_suffix(f".{uuid.uuid4()}.tmp")
+                shutil.copyfile(artifact, staging)
+                os.replace(staging, cache_entry.with_suffix(suffix))
         return returncode
 
     def run_simple_switch_grpc(
@@ -165,7 +219,7 @@ class VethEnv(ProtobufTestEnv):
             "---------------------- Start simple_switch_grpc ----------------------",
         )
         interface_map = self.get_interface_map(interface_count=self.options.interface_count)
-        thrift_port = testutils.pick_tcp_port(GRPC_ADDRESS, THRIFT_PORT)
+        thrift_port = testutils.pick_tcp_port(GRPC_ADDRESS, self.options.thrift_port)
         simple_switch_grpc = (
             f"simple_switch_grpc --thrift-port {thrift_port} --device-id 0 --log-file {switchlog} "
             f"{interface_map} --log-flush --no-p4 "
@@ -200,8 +254,15 @@ class VethEnv(ProtobufTestEnv):
         ifaces = self.get_iface_str(num_ifaces=self.options.interface_count, prefix="br_")
         test_params = (
             f"grpcaddr='{GRPC_ADDRESS}:{grpc_port}';p4info='{info_name}';config='{json_name}';"
-            f"packet_wait_time='0.1';initial_config_file='{self.options.testfile}'"
+            "packet_wait_time='0.1';"
         )
+        if len(self.options.testfiles) == 1:
+            test_params += f"initial_config_file='{self.options.testfiles[0]}'"
+        else:
+            # Pass many configs through a file to keep the command line short.
+            config_list = self.options.testdir.joinpath("initial_configs.txt")
+            config_list.write_text("".join(f"{testfile}\n" for testfile in self.options.testfiles))
+            test_params += f"initial_config_list='{config_list}'"
         run_ptf_cmd = (
             f"ptf --pypath {pypath} {ifaces} --log-file {self.options.testdir.joinpath('ptf.log')} "
             f"--test-params={test_params} --test-dir {FILE_DIR}"
@@ -226,7 +287,7 @@ def run_test(options: Options) -> int:
 
     # Pick available ports for the gRPC switch.
     switchlog = options.testdir.joinpath("switchlog")
-    grpc_port = testutils.pick_tcp_port(GRPC_ADDRESS, P4RUNTIME_PORT)
+    grpc_port = testutils.pick_tcp_port(GRPC_ADDRESS, options.grpc_port)
     switch_proc = testenv.run_simple_switch_grpc(switchlog, grpc_port)
     if switch_proc is None:
         return testutils.FAILURE
@@ -265,14 +326,18 @@ def create_options(test_args: testutils.Any) -> testutils.Optional[Options]:
     if not result:
         return None
     options.p4_file = result
-    testfile = test_args.testfile
-    if not testfile:
+    testfiles = test_args.testfile
+    if not testfiles:
         testutils.log.info("No test file provided. Checking for file in folder.")
-        testfile = options.p4_file.with_suffix(".txtpb")
-    result = testutils.check_if_file(testfile)
-    if not result:
-        return None
-    options.testfile = result
+        testfiles = [options.p4_file.with_suffix(".txtpb")]
+    options.testfiles = []
+    for testfile in testfiles:
+        result = testutils.check_if_file(testfile)
+        if not result:
+            return None
+        options.testfiles.append(result)
+    if test_args.cache_dir:
+        options.cache_dir = Path(test_args.cache_dir).absolute()
     testdir = test_args.testdir
     if not testdir:
         testutils.log.info("No test directory provided. Generating temporary folder.")
@@ -282,6 +347,10 @@ def create_options(test_args: testutils.Any) -> testutils.Optional[Options]:
     options.testdir = Path(testdir)
     options.rootdir = Path(test_args.rootdir)
     options.interface_count = test_args.interface_count
+    if test_args.grpc_port is not None:
+        options.grpc_port = test_args.grpc_port
+    if test_args.thrift_port is not None:
+        options.thrift_port = test_args.thrift_port
     # Configure logging.
     logging.basicConfig(
         filename=options.testdir.joinpath("test.log"),
@@ -1,11 +1,15 @@
 import argparse
+import json
 import logging
 import os
+import queue
 import subprocess
 import sys
 import tempfile
+import time
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import Any, Optional
+from typing import Any, Dict, List, Optional
 
 PARSER = argparse.ArgumentParser()
 PARSER.add_argument(
@@ -24,7 +28,58 @@ PARSER.add_argument(
     "--seed",
     default=1,
     dest="seed",
-    help="Random seed for generating configs.",
+    help="Random seed for generating configs. The first seed of the batch.",
+)
+PARSER.add_argument(
+    "-n",
+    "--num-seeds",
+    default=1,
+    type=int,
+    dest="num_seeds",
+    help="The number of consecutive seeds, starting at the given seed, to test.",
+)
+PARSER.add_argument(
+    "-j",
+    "--jobs",
+    default=1,
+    type=int,
+    dest="jobs",
+    help="The number of seeds to test concurrently. Every job runs its own BMv2 instance.",
+)
+PARSER.add_argument(
+    "--summary",
+    default=None,
+    dest="summary",
+    help="The path of the JSON summary of the batch. Defaults to summary.json in the test "
+    "directory.",
+)
+PARSER.add_argument(
+    "--grpc-port",
+    default=9559,
+    type=int,
+    dest="grpc_port",
+    help="The first P4Runtime port. Job i uses the ports starting at this port plus i * 100.",
+)
+PARSER.add_argument(
+    "--thrift-port",
+    default=22000,
+    type=int,
+    dest="thrift_port",
+    help="The first Thrift port. Job i uses the ports starting at this port plus i * 100.",
+)
+PARSER.add_argument(
+    "--cache-dir",
+    default=None,
+    dest="cache_dir",
+    help="The directory that caches the compiled program across tests. Defaults to "
+    "compile_cache in the test directory.",
+)
+PARSER.add_argument(
+    "--single-switch",
+    action="store_true",
+    dest="single_switch",
+    help="Generate the configs of all seeds first, then test all of them against a single "
+    "switch instance, which is reset between configs.",
 )
 
 
@@ -34,6 +89,13 @@ ARGS, ARGV = PARSER.parse_known_args()
 # Append the root directory to the import path.
 FILE_DIR = Path(__file__).resolve().parent
 
+# The distance between the port ranges of two concurrent jobs. The switch picks the first free
+# port at or above the base port of its job, so the jobs do not race for the same ports.
+PORT_STRIDE = 100
+
+# The name of the generated config in the directory of a seed.
+CONFIG_FILE_NAME = "initial_config.txtpb"
+
 
 class Options:
     """Options for this testing script. Usually correspond to command line inputs."""
@@ -44,18 +106,39 @@ class Options:
     p4rtsmith: Path = Path(".")
     # Actual location of the test framework.
     testdir: Path = Path(".")
-    # Random seed for generating configs.
+    # Random seed for generating configs. The first seed of the batch.
     seed: int = 1
+    # The number of consecutive seeds to test.
+    num_seeds: int = 1
+    # The number of seeds to test concurrently.
+    jobs: int = 1
+    # The path of the JSON summary of the batch.
+    summary: Path = Path(".")
+    # The first P4Runtime port.
+    grpc_port: int = 9559
+    # The first Thrift port.
+    thrift_port: int = 22000
+    # The directory that caches the compiled program across tests.
+    cache_dir: Path = Path(".")
+    # Whether to test all configs against a single switch instance.
+    single_switch: bool = False
 
 
-def generate_config(p4rtsmith_path, seed, p4_program_path, testdir, config_file_path):
+def generate_config(p4rtsmith_path, seed, p4_program_path, testdir, config_file_path) -> int:
     command = f"{p4rtsmith_path} --target bmv2 --arch v1model --seed {seed} --output-dir {testdir} --generate-config {config_file_path} {p4_program_path}"
-    subprocess.run(command, shell=True)
+    return subprocess.run(command, shell=True, check=False).returncode
 
 
-def run_test(run_test_script, p4_program_path, config_file_path):
-    command = f"sudo -E {run_test_script} .. {p4_program_path} -tf {config_file_path}"
-    subprocess.run(command, shell=True)
+def run_test(
+    run_test_script, p4_program_path, config_file_paths, testdir, grpc_port, thrift_port, cache_dir
+) -> int:
+    # Every invocation creates its own network namespace, so concurrent switches are isolated.
+    config_files = " ".join(str(config_file_path) for config_file_path in config_file_paths)
+    command = (
+        f"sudo -E {run_test_script} .. {p4_program_path} -tf {config_files} -td {testdir} "
+        f"--grpc-port {grpc_port} --thrift-port {thrift_port} --cache-dir {cache_dir}"
+    )
+    return subprocess.run(command, shell=True, check=False).returncode
 
 
 def find_p4c_dir():
@@ -72,17 +155,134 @@ def find_p4c_dir():
             raise RuntimeError("p4c/build directory not found.")
 
 
-def run_tests(options: Options) -> int:
-    config_file_path = "initial_config.txtpb"
+def generate_seed(options: Options, seed: int) -> Dict[str, Any]:
+    """Generate the config for a seed in its own directory. Returns the result of the seed."""
+    testdir = options.testdir / f"seed_{seed}"
+    testdir.mkdir(parents=True, exist_ok=True)
+    os.chmod(testdir, 0o755)
+
+    result: Dict[str, Any] = {"seed": seed, "testdir": str(testdir)}
+    start = time.monotonic()
+    result["generate_returncode"] = generate_config(
+        options.p4rtsmith, seed, options.p4_file, testdir, CONFIG_FILE_NAME
+    )
+    result["generate_seconds"] = time.monotonic() - start
+    return result
+
+
+def run_seed(options: Options, seed: int, job: int) -> Dict[str, Any]:
+    """Generate the config for a seed and test it on the BMv2 instance of the given job.
+    Returns the result of the seed."""
+    result = generate_seed(options, seed)
+    # The switch and PTF artifacts go into a subdirectory of the seed directory.
+    testdir = Path(result["testdir"])
+    switchdir = testdir / "bmv2"
+    switchdir.mkdir(exist_ok=True)
+    result["grpc_port"] = options.grpc_port + job * PORT_STRIDE
+    result["thrift_port"] = options.thrift_port + job * PORT_STRIDE
+
+    test_returncode = None
+    if result["generate_returncode"] == 0:
+        start = time.monotonic()
+        test_returncode = run_test(
+            FILE_DIR / "run-bmv2-proto-test.py",
+            options.p4_file,
+            [testdir / CONFIG_FILE_NAME],
+            switchdir,
+            result["grpc_port"],
+            result["thrift_port"],
+            options.cache_dir,
+        )
+        result["test_seconds"] = time.monotonic() - start
+    result["test_returncode"] = test_returncode
+    result["passed"] = test_returncode == 0
+    if not result["passed"]:
+        logging.error("Seed %s failed. Artifacts are in %s.", seed, testdir)
+    return result
+
+
+def run_single_switch(options: Options, seeds: range, jobs: int) -> List[Dict[str, Any]]:
+    """Generate the configs of all seeds concurrently, then test all of them against one switch.
+    Returns the results of the seeds."""
+    with ThreadPoolExecutor(max_workers=jobs) as executor:
+        results = list(executor.map(lambda seed: generate_seed(options, seed), seeds))
+    generated = [result for result in results if result["generate_returncode"] == 0]
+    switchdir = options.testdir / "bmv2"
+    switchdir.mkdir(parents=True, exist_ok=True)
 
-    seed = options.seed
-    testdir = options.testdir
-    p4rtsmith_path = options.p4rtsmith
-    run_test_script = FILE_DIR / "run-bmv2-proto-test.py"
-    p4_program_path = options.p4_file
+    test_returncode = None
+    if generated:
+        start = time.monotonic()
+        test_returncode = run_test(
+            FILE_DIR / "run-bmv2-proto-test.py",
+            options.p4_file,
+            [Path(result["testdir"]) / CONFIG_FILE_NAME for result in generated],
+            switchdir,
+            options.grpc_port,
+            options.thrift_port,
+            options.cache_dir,
+        )
+        test_seconds = time.monotonic() - start
+        # The configs share one test run, attribute an equal share of its time to every seed.
+        for result in generated:
+            result["test_seconds"] = test_seconds / len(generated)
+    for result in results:
+        # The test run does not tell which configs failed, that is only in the PTF log.
+        result["test_returncode"] = (
+            test_returncode if result["generate_returncode"] == 0 else None
+        )
+        result["passed"] = result["test_returncode"] == 0
+    if test_returncode != 0:
+        logging.error("The single switch test failed. Artifacts are in %s.", switchdir)
+    return results
 
-    generate_config(p4rtsmith_path, seed, p4_program_path, testdir, config_file_path)
-    run_test(run_test_script, p4_program_path, testdir / config_file_path)
+
+def run_parallel_switches(options: Options, seeds: range, jobs: int) -> List[Dict[str, Any]]:
+    """Test every seed on its own switch, running up to `jobs` switches concurrently.
+    Returns the results of the seeds."""
+    # Every running seed holds one job slot, which determines its ports.
+    free_jobs: "queue.Queue[int]" = queue.Queue()
+    for job in range(jobs):
+        free_jobs.put(job)
+
+    def run_in_free_job(seed: int) -> Dict[str, Any]:
+        job = free_jobs.get()
+        try:
+            return run_seed(options, seed, job)
+        finally:
+            free_jobs.put(job)
+
+    with ThreadPoolExecutor(max_workers=jobs) as executor:
+        return list(executor.map(run_in_free_job, seeds))
+
+
+def run_tests(options: Options) -> int:
+    seeds = range(options.seed, options.seed + options.num_seeds)
+    jobs = max(1, min(options.jobs, len(seeds)))
+    start = time.monotonic()
+    if options.single_switch:
+        results = run_single_switch(options, seeds, jobs)
+    else:
+        results = run_parallel_switches(options, seeds, jobs)
+    failed = [result["seed"] for result in results if not result["passed"]]
+    summary = {
+        "p4_file": str(options.p4_file),
+        "jobs": jobs,
+        "single_switch": options.single_switch,
+        "wall_seconds": time.monotonic() - start,
+        "passed": len(results) - len(failed),
+        "failed": failed,
+        "seeds": results,
+    }
+    with open(options.summary, "w", encoding="utf-8") as summary_file:
+        json.dump(summary, summary_file, indent=2)
+    logging.warning(
+        "%s of %s seeds passed. The summary is in %s.",
+        summary["passed"],
+        len(results),
+        options.summary,
+    )
+    return 1 if failed else 0
 
 
 def create_options(test_args: Any) -> Optional[Options]:
@@ -100,7 +300,22 @@ def create_options(test_args: Any) -> Optional[Options]:
         testdir = tempfile.mkdtemp(dir=Path(".").absolute())
         os.chmod(testdir, 0o755)
     options.testdir = Path(testdir)
-    options.seed = test_args.seed
+    options.seed = int(test_args.seed)
+    options.num_seeds = test_args.num_seeds
+    options.jobs = test_args.jobs
+    options.grpc_port = test_args.grpc_port
+    options.thrift_port = test_args.thrift_port
+    options.cache_dir = (
+        Path(test_args.cache_dir).absolute()
+        if test_args.cache_dir
+        else options.testdir.joinpath("compile_cache")
+    )
+    options.single_switch = test_args.single_switch
+    options.summary = (
+        Path(test_args.summary).absolute()
+        if test_args.summary
+        else options.testdir.joinpath("summary.json")
+    )
 
     # Configure logging.
     logging.basicConfig(
@@ -120,4 +335,4 @@ if __name__ == "__main__":
     if not test_options:
         sys.exit()
 
-    run_tests(test_options)
+    sys.exit(run_tests(test_options))
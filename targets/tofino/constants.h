@@ -36,6 +36,24 @@ class TnaConstants {
     /// Meter colors are defined in v1model.p4
     enum METER_COLOR { GREEN = 0, YELLOW = 1, RED = 2 };
 
+    /// Reserved BFRuntime fields of action profiles and action selectors. The ids follow the
+    /// bfrt.json schema bf-p4c generates.
+    /// The "$ACTION_MEMBER_ID" key field of an action profile table.
+    static constexpr uint32_t ACTION_PROFILE_MEMBER_ID_KEY_ID = 1;
+    /// The "$SELECTOR_GROUP_ID" key field of an action selector table.
+    static constexpr uint32_t SELECTOR_GROUP_ID_KEY_ID = 1;
+    /// The "$ACTION_MEMBER_ID" and "$ACTION_MEMBER_STATUS" array data fields of an action
+    /// selector table, and its "$MAX_GROUP_SIZE" data field.
+    static constexpr uint32_t SELECTOR_MEMBER_ID_FIELD_ID = 1;
+    static constexpr uint32_t SELECTOR_MEMBER_STATUS_FIELD_ID = 2;
+    static constexpr uint32_t SELECTOR_MAX_GROUP_SIZE_FIELD_ID = 3;
+    /// The "$ACTION_MEMBER_ID" and "$SELECTOR_GROUP_ID" data fields of a match table that uses an
+    /// action profile or an action selector.
+    static constexpr uint32_t TABLE_ACTION_MEMBER_ID_FIELD_ID = 65537;
+    static constexpr uint32_t TABLE_SELECTOR_GROUP_ID_FIELD_ID = 65538;
+    /// The width of member and group ids.
+    static constexpr int ACTION_PROFILE_ID_WIDTH = 32;
+
     /// Other useful constants
     static constexpr int STF_MIN_PKT_SIZE = 22;
     static constexpr int ETH_HDR_SIZE = 112;
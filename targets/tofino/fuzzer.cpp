@@ -1,9 +1,11 @@
 #include "backends/p4tools/modules/rtsmith/targets/tofino/fuzzer.h"
 
 #include <algorithm>
+#include <string>
 
 #include "backends/p4tools/common/lib/util.h"
 #include "backends/p4tools/modules/rtsmith/core/fuzzer.h"
+#include "backends/p4tools/modules/rtsmith/targets/tofino/constants.h"
 #include "control-plane/p4infoApi.h"
 
 namespace P4::P4Tools::RtSmith::Tna {
@@ -21,10 +23,11 @@ bfrt_proto::KeyField_Exact TofinoTnaFuzzer::produceKeyField_Exact(int bitwidth)
     return protoExact;
 }
 
-bfrt_proto::KeyField_LPM TofinoTnaFuzzer::produceKeyField_LPM(int bitwidth) {
+bfrt_proto::KeyField_LPM TofinoTnaFuzzer::produceKeyField_LPM(int bitwidth,
+                                                              const TablePolicy &policy) {
     bfrt_proto::KeyField_LPM protoLPM;
     protoLPM.set_value(produceBytes(bitwidth));
-    protoLPM.set_prefix_len(Utils::getRandInt(0, bitwidth));
+    protoLPM.set_prefix_len(producePrefixLength(bitwidth, policy));
     return protoLPM;
 }
 
@@ -77,7 +80,8 @@ bfrt_proto::TableData TofinoTnaFuzzer::produceTableData(
     return protoTableData;
 }
 
-bfrt_proto::KeyField TofinoTnaFuzzer::produceKeyField(const p4::config::v1::MatchField &match) {
+bfrt_proto::KeyField TofinoTnaFuzzer::produceKeyField(const p4::config::v1::MatchField &match,
+                                                      const TablePolicy &policy) {
     bfrt_proto::KeyField protoKeyField;
     protoKeyField.set_field_id(match.id());
     auto matchType = match.match_type();
@@ -88,10 +92,15 @@ bfrt_proto::KeyField TofinoTnaFuzzer::produceKeyField(const p4::config::v1::Matc
             protoKeyField.mutable_exact()->CopyFrom(produceKeyField_Exact(bitwidth));
             break;
         case p4::config::v1::MatchField::LPM:
-            protoKeyField.mutable_lpm()->CopyFrom(produceKeyField_LPM(bitwidth));
+            protoKeyField.mutable_lpm()->CopyFrom(produceKeyField_LPM(bitwidth, policy));
             break;
         case p4::config::v1::MatchField::TERNARY:
             protoKeyField.mutable_ternary()->CopyFrom(produceKeyField_Ternary(bitwidth));
+            // A wildcard does not care about any bit of the field.
+            if (produceWildcard(policy)) {
+                protoKeyField.mutable_ternary()->set_value(produceBytes(bitwidth, 0));
+                protoKeyField.mutable_ternary()->set_mask(produceBytes(bitwidth, 0));
+            }
             break;
         case p4::config::v1::MatchField::RANGE:
             protoKeyField.mutable_range()->CopyFrom(produceKeyField_Range(bitwidth));
@@ -108,7 +117,8 @@ bfrt_proto::KeyField TofinoTnaFuzzer::produceKeyField(const p4::config::v1::Matc
 
 bfrt_proto::TableEntry TofinoTnaFuzzer::produceTableEntry(
     const p4::config::v1::Table &table,
-    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+    const TablePolicy &policy) {
     bfrt_proto::TableEntry protoEntry;
 
     // set table id
@@ -119,59 +129,460 @@ bfrt_proto::TableEntry TofinoTnaFuzzer::produceTableEntry(
     const auto &matchFields = table.match_fields();
     for (auto i = 0; i < matchFields.size(); i++) {
         auto match = matchFields[i];
-        protoEntry.mutable_key()->add_fields()->CopyFrom(produceKeyField(matchFields[i]));
+        protoEntry.mutable_key()->add_fields()->CopyFrom(produceKeyField(matchFields[i], policy));
     }
 
     // add action
-    const auto &action_refs = table.action_refs();
-    protoEntry.mutable_data()->CopyFrom(produceTableData(action_refs, actions));
+    *protoEntry.mutable_data() = produceEntryData(table, actions);
 
     return protoEntry;
 }
 
-InitialConfig TofinoTnaFuzzer::produceInitialConfig() {
-    auto request = std::make_unique<bfrt_proto::WriteRequest>();
+namespace {
+
+/// @returns the id of the action profile member or action selector group @param entry.
+uint32_t getActionProfileObjectId(const bfrt_proto::TableEntry &entry) {
+    uint32_t id = 0;
+    for (const auto &field : entry.key().fields()) {
+        if (field.field_id() == TnaConstants::ACTION_PROFILE_MEMBER_ID_KEY_ID) {
+            for (auto byte : field.exact().value()) {
+                id = (id << 8) | static_cast<uint8_t>(byte);
+            }
+        }
+    }
+    return id;
+}
 
-    auto p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+/// @returns the ids of the members of the action selector group @param group.
+std::vector<uint32_t> getGroupMemberIds(const bfrt_proto::TableEntry &group) {
+    for (const auto &field : group.data().fields()) {
+        if (field.field_id() == TnaConstants::SELECTOR_MEMBER_ID_FIELD_ID) {
+            return {field.int_arr_val().val().begin(), field.int_arr_val().val().end()};
+        }
+    }
+    return {};
+}
 
-    /// TODO: for Tofino, we also need to look at externs instances for
-    /// ActionSelector, ActionProfile and so on.
-    const auto tables = p4Info->tables();
+/// Set the members of the action selector group @param group to @param memberIds. All members
+/// are active.
+void setGroupMemberIds(bfrt_proto::TableEntry &group, const std::vector<uint32_t> &memberIds) {
+    for (auto &field : *group.mutable_data()->mutable_fields()) {
+        if (field.field_id() == TnaConstants::SELECTOR_MEMBER_ID_FIELD_ID) {
+            field.mutable_int_arr_val()->mutable_val()->Assign(memberIds.begin(), memberIds.end());
+        } else if (field.field_id() == TnaConstants::SELECTOR_MEMBER_STATUS_FIELD_ID) {
+            auto *status = field.mutable_bool_arr_val()->mutable_val();
+            status->Clear();
+            status->Resize(static_cast<int>(memberIds.size()), true);
+        }
+    }
+}
+
+}  // namespace
+
+bfrt_proto::TableData TofinoTnaFuzzer::produceEntryData(
+    const p4::config::v1::Table &table,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    if (table.implementation_id() == 0) {
+        return produceTableData(table.action_refs(), actions);
+    }
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    const auto &profileName =
+        findActionProfile(*p4Info, table.implementation_id()).preamble().name();
+    const auto &members = actionProfileMembers[profileName];
+    const auto &groups = selectorGroups[profileName];
+    BUG_CHECK(!members.empty(), "Action profile %1% has no members.", profileName);
+
+    bfrt_proto::TableData protoTableData;
+    auto *protoDataField = protoTableData.add_fields();
+    // Entries of tables with a selector refer to a group or a single member with equal chance.
+    if (!groups.empty() && Utils::getRandInt(0, 1) == 0) {
+        protoDataField->set_field_id(TnaConstants::TABLE_SELECTOR_GROUP_ID_FIELD_ID);
+        protoDataField->set_stream(
+            produceBytes(TnaConstants::ACTION_PROFILE_ID_WIDTH,
+                         getActionProfileObjectId(groups.entryAt(groups.samplePosition()))));
+    } else {
+        protoDataField->set_field_id(TnaConstants::TABLE_ACTION_MEMBER_ID_FIELD_ID);
+        protoDataField->set_stream(
+            produceBytes(TnaConstants::ACTION_PROFILE_ID_WIDTH,
+                         getActionProfileObjectId(members.entryAt(members.samplePosition()))));
+    }
+    return protoTableData;
+}
+
+bfrt_proto::TableEntry TofinoTnaFuzzer::produceActionProfileMember(
+    const p4::config::v1::ActionProfile &profile, uint32_t memberId,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &actionRefs,
+    const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions) {
+    bfrt_proto::TableEntry protoEntry;
+    protoEntry.set_table_id(profile.preamble().id());
+    auto *protoKeyField = protoEntry.mutable_key()->add_fields();
+    protoKeyField->set_field_id(TnaConstants::ACTION_PROFILE_MEMBER_ID_KEY_ID);
+    protoKeyField->mutable_exact()->set_value(
+        produceBytes(TnaConstants::ACTION_PROFILE_ID_WIDTH, memberId));
+    *protoEntry.mutable_data() = produceTableData(actionRefs, actions);
+    return protoEntry;
+}
+
+bfrt_proto::TableEntry TofinoTnaFuzzer::produceSelectorGroup(
+    const p4::config::v1::ActionProfile &profile, uint32_t groupId,
+    const TableState<bfrt_proto::TableEntry> &members) {
+    std::vector<uint32_t> memberIds;
+    for (auto position :
+         sampleDistinctIds(produceGroupSize(profile, members.size()), members.size())) {
+        memberIds.push_back(getActionProfileObjectId(members.entryAt(position - 1)));
+    }
+
+    bfrt_proto::TableEntry protoEntry;
+    // NOTE: P4Info describes an action selector and its action profile as a single object, so the
+    // selector table shares the id of the action profile.
+    protoEntry.set_table_id(profile.preamble().id());
+    auto *protoKeyField = protoEntry.mutable_key()->add_fields();
+    protoKeyField->set_field_id(TnaConstants::SELECTOR_GROUP_ID_KEY_ID);
+    protoKeyField->mutable_exact()->set_value(
+        produceBytes(TnaConstants::ACTION_PROFILE_ID_WIDTH, groupId));
+    auto *protoData = protoEntry.mutable_data();
+    auto *maxGroupSizeField = protoData->add_fields();
+    maxGroupSizeField->set_field_id(TnaConstants::SELECTOR_MAX_GROUP_SIZE_FIELD_ID);
+    maxGroupSizeField->set_stream(produceBytes(32, getMaxGroupSize(profile)));
+    protoData->add_fields()->set_field_id(TnaConstants::SELECTOR_MEMBER_ID_FIELD_ID);
+    protoData->add_fields()->set_field_id(TnaConstants::SELECTOR_MEMBER_STATUS_FIELD_ID);
+    setGroupMemberIds(protoEntry, memberIds);
+    return protoEntry;
+}
+
+void TofinoTnaFuzzer::churnSelectorGroup(const p4::config::v1::ActionProfile &profile,
+                                         bfrt_proto::TableEntry &group,
+                                         const TableState<bfrt_proto::TableEntry> &members) {
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
+    auto memberIds = getGroupMemberIds(group);
+    auto groupSize = static_cast<int64_t>(memberIds.size());
+    bool canGrow = groupSize < getMaxGroupSize(profile) &&
+                   groupSize < static_cast<int64_t>(members.size());
+    bool canShrink = groupSize > std::max(fuzzerConfig.getMinGroupSize(), 1);
+    if (canGrow && (!canShrink || Utils::getRandInt(0, 1) == 0)) {
+        // Add a member that is not part of the group yet.
+        std::vector<uint32_t> candidates;
+        for (size_t position = 0; position < members.size(); position++) {
+            auto memberId = getActionProfileObjectId(members.entryAt(position));
+            if (std::find(memberIds.begin(), memberIds.end(), memberId) == memberIds.end()) {
+                candidates.push_back(memberId);
+            }
+        }
+        memberIds.push_back(candidates.at(Utils::getRandInt(candidates.size() - 1)));
+    } else if (canShrink) {
+        memberIds.erase(memberIds.begin() + Utils::getRandInt(memberIds.size() - 1));
+    }
+    setGroupMemberIds(group, memberIds);
+}
+
+void TofinoTnaFuzzer::produceActionProfileUpdates(
+    bool isInitialConfig, WriteRequestBatcher<bfrt_proto::WriteRequest> &batcher) {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    const auto &fuzzerConfig = getProgramInfo().getFuzzerConfig();
     const auto actions = p4Info->actions();
 
-    auto tableCnt = tables.size();
+    // Members first, so that groups and table entries can refer to them.
+    for (const auto &profile : p4Info->action_profiles()) {
+        const auto *table = findActionProfileTable(*p4Info, profile.preamble().id());
+        if (table == nullptr) {
+            continue;
+        }
+        auto &members = actionProfileMembers[profile.preamble().name()];
+        auto &nextMemberId = nextMemberIds.try_emplace(profile.preamble().name(), 1).first->second;
+        auto maxMembers = static_cast<size_t>(fuzzerConfig.getMaxActionProfileMembers());
+        if (profile.size() > 0) {
+            maxMembers = std::min(maxMembers, static_cast<size_t>(profile.size()));
+        }
+        if (maxMembers == 0) {
+            continue;
+        }
+        if (isInitialConfig) {
+            while (members.size() < maxMembers) {
+                auto memberId = nextMemberId++;
+                auto member =
+                    produceActionProfileMember(profile, memberId, table->action_refs(), actions);
+                bfrt_proto::Update update;
+                update.set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
+                *update.mutable_entity()->mutable_table_entry() = member;
+                batcher.add(std::move(update));
+                members.insert(std::to_string(memberId), std::move(member));
+            }
+            continue;
+        }
+        if (Utils::getRandInt(0, 1) == 0) {
+            continue;
+        }
+        // Members are never deleted, deletions modify the action of a member instead.
+        bfrt_proto::Update update;
+        if (members.size() < maxMembers &&
+            pickUpdateOperation(!members.empty()) == UpdateOperation::Insert) {
+            auto memberId = nextMemberId++;
+            auto member =
+                produceActionProfileMember(profile, memberId, table->action_refs(), actions);
+            update.set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
+            *update.mutable_entity()->mutable_table_entry() = member;
+            members.insert(std::to_string(memberId), std::move(member));
+        } else if (!members.empty()) {
+            auto &member = members.entryAt(members.samplePosition());
+            *member.mutable_data() = produceTableData(table->action_refs(), actions);
+            update.set_type(bfrt_proto::Update_Type::Update_Type_MODIFY);
+            *update.mutable_entity()->mutable_table_entry() = member;
+        } else {
+            continue;
+        }
+        batcher.add(std::move(update));
+    }
+    batcher.flush();
 
-    for (auto tableId = 0; tableId < tableCnt; tableId++) {
-        /// NOTE: temporary use a coin to decide if generating entries for the table
+    // Groups second, so that table entries can refer to them.
+    for (const auto &profile : p4Info->action_profiles()) {
+        const auto &members = actionProfileMembers[profile.preamble().name()];
+        if (!profile.with_selector() || members.empty()) {
+            continue;
+        }
+        auto &groups = selectorGroups[profile.preamble().name()];
+        auto &nextGroupId = nextGroupIds.try_emplace(profile.preamble().name(), 1).first->second;
+        auto maxGroups = static_cast<size_t>(fuzzerConfig.getMaxSelectorGroups());
+        if (maxGroups == 0) {
+            continue;
+        }
+        if (isInitialConfig) {
+            while (groups.size() < maxGroups) {
+                auto groupId = nextGroupId++;
+                auto group = produceSelectorGroup(profile, groupId, members);
+                bfrt_proto::Update update;
+                update.set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
+                *update.mutable_entity()->mutable_table_entry() = group;
+                batcher.add(std::move(update));
+                groups.insert(std::to_string(groupId), std::move(group));
+            }
+            continue;
+        }
         if (Utils::getRandInt(0, 1) == 0) {
             continue;
         }
-        auto table = tables.Get(tableId);
-        if (table.match_fields_size() == 0 || table.is_const_table()) {
+        // Groups are never deleted, the update series churns their membership instead.
+        bfrt_proto::Update update;
+        if (groups.size() < maxGroups &&
+            pickUpdateOperation(!groups.empty()) == UpdateOperation::Insert) {
+            auto groupId = nextGroupId++;
+            auto group = produceSelectorGroup(profile, groupId, members);
+            update.set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
+            *update.mutable_entity()->mutable_table_entry() = group;
+            groups.insert(std::to_string(groupId), std::move(group));
+        } else if (!groups.empty()) {
+            auto &group = groups.entryAt(groups.samplePosition());
+            churnSelectorGroup(profile, group, members);
+            update.set_type(bfrt_proto::Update_Type::Update_Type_MODIFY);
+            *update.mutable_entity()->mutable_table_entry() = group;
+        } else {
             continue;
         }
-        /// TODO: remove this `min`. It is for ease of debugging now.
-        auto maxEntryGenCnt = std::min(table.size(), (int64_t)4);
-        std::set<std::string> matchFields;
-        for (auto i = 0; i < maxEntryGenCnt; i++) {
-            auto entry = produceTableEntry(table, actions);
-            std::string stringKey = entry.key().SerializeAsString();
-            if (matchFields.find(stringKey) == matchFields.end()) {
-                /// Only insert unique entries
-                auto update = request->add_updates();
-                /// TODO: add support for other types.
+        batcher.add(std::move(update));
+    }
+    batcher.flush();
+}
+
+std::string TofinoTnaFuzzer::computeEntryKey(const bfrt_proto::TableEntry &entry) {
+    return computeCanonicalKey(entry.key().fields());
+}
+
+void TofinoTnaFuzzer::produceUpdates(bool isInitialConfig,
+                                     WriteRequestBatcher<bfrt_proto::WriteRequest> &batcher,
+                                     uint64_t maxUpdatesPerTable, bool insertOnly) {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+
+    produceActionProfileUpdates(isInitialConfig, batcher);
+
+    const auto tables = p4Info->tables();
+    const auto actions = p4Info->actions();
+
+    for (auto tableId : selectTables()) {
+        const auto &policy = getTablePolicy(tableId);
+        const auto &table = tables.Get(tableId);
+        // Entries of tables with an action profile need a member to refer to.
+        if (table.implementation_id() != 0) {
+            const auto &profile = findActionProfile(*p4Info, table.implementation_id());
+            if (actionProfileMembers[profile.preamble().name()].empty()) {
+                continue;
+            }
+        }
+        produceTableEntryUpdates(
+            table, policy, currentState[table.preamble().name()],
+            deletedEntries[table.preamble().name()], isInitialConfig, insertOnly,
+            maxUpdatesPerTable, batcher,
+            [&]() { return produceTableEntry(table, actions, policy); }, computeEntryKey,
+            [&](UpdateOperation operation, const std::string & /*entryKey*/,
+                bfrt_proto::TableEntry &entry) {
+                bfrt_proto::Update update;
+                switch (operation) {
+                    case UpdateOperation::Insert:
+                        update.set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
+                        *update.mutable_entity()->mutable_table_entry() = entry;
+                        break;
+                    case UpdateOperation::Modify:
+                        // Keep the key, only replace the action data.
+                        *entry.mutable_data() = produceEntryData(table, actions);
+                        update.set_type(bfrt_proto::Update_Type::Update_Type_MODIFY);
+                        *update.mutable_entity()->mutable_table_entry() = entry;
+                        break;
+                    case UpdateOperation::Delete: {
+                        // Deletions only need the key of the entry.
+                        update.set_type(bfrt_proto::Update_Type::Update_Type_DELETE);
+                        auto *deletedEntry = update.mutable_entity()->mutable_table_entry();
+                        deletedEntry->set_table_id(entry.table_id());
+                        *deletedEntry->mutable_key() = entry.key();
+                        break;
+                    }
+                }
+                return update;
+            });
+    }
+}
+
+std::unique_ptr<bfrt_proto::ReadRequest> TofinoTnaFuzzer::produceReadRequest() {
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    if (p4Info->tables_size() == 0) {
+        return nullptr;
+    }
+    std::vector<const TableState<bfrt_proto::TableEntry> *> installedTables;
+    for (const auto &[tableName, tableState] : currentState) {
+        if (!tableState.empty()) {
+            installedTables.push_back(&tableState);
+        }
+    }
+
+    auto request = std::make_unique<bfrt_proto::ReadRequest>();
+    auto *protoEntry = request->add_entities()->mutable_table_entry();
+    if (!installedTables.empty() && Utils::getRandInt(0, 1) == 0) {
+        // An entry is identified by its table and its key.
+        const auto &tableState =
+            *installedTables.at(Utils::getRandInt(installedTables.size() - 1));
+        const auto &entry = tableState.entryAt(tableState.samplePosition());
+        protoEntry->set_table_id(entry.table_id());
+        *protoEntry->mutable_key() = entry.key();
+    } else {
+        const auto &table = p4Info->tables(Utils::getRandInt(p4Info->tables_size() - 1));
+        protoEntry->set_table_id(table.preamble().id());
+    }
+    return request;
+}
+
+ProtobufMessagePtr TofinoTnaFuzzer::produceEmptyWriteRequest() const {
+    return std::make_unique<bfrt_proto::WriteRequest>();
+}
+
+ProtobufMessagePtr TofinoTnaFuzzer::produceEmptyReadResponse() const {
+    return std::make_unique<bfrt_proto::ReadResponse>();
+}
+
+ProtobufMessagePtr TofinoTnaFuzzer::produceStateSnapshot() const {
+    auto request = std::make_unique<bfrt_proto::WriteRequest>();
+    auto addInsertions = [&request](const auto &stateMap) {
+        for (const auto &[name, state] : stateMap) {
+            for (size_t position = 0; position < state.size(); ++position) {
+                auto *update = request->add_updates();
                 update->set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
-                matchFields.insert(std::move(stringKey));
-                update->mutable_entity()->mutable_table_entry()->CopyFrom(entry);
+                *update->mutable_entity()->mutable_table_entry() = state.entryAt(position);
             }
         }
+    };
+    // Members first and groups second, so that table entries can refer to them.
+    addInsertions(actionProfileMembers);
+    addInsertions(selectorGroups);
+    addInsertions(currentState);
+    return request;
+}
+
+bool TofinoTnaFuzzer::applyWriteRequest(const google::protobuf::Message &request) {
+    const auto *writeRequest = dynamic_cast<const bfrt_proto::WriteRequest *>(&request);
+    if (writeRequest == nullptr) {
+        error("P4RuntimeSmith: Expected a BFRuntime write request, got a %1%.",
+              request.GetDescriptor()->full_name());
+        return false;
     }
+    for (const auto &update : writeRequest->updates()) {
+        if (!applyUpdate(update)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    InitialConfig initialConfig;
-    initialConfig.push_back(std::move(request));
-    return initialConfig;
+bool TofinoTnaFuzzer::applyReadResponse(google::protobuf::Message &response) {
+    auto *readResponse = dynamic_cast<bfrt_proto::ReadResponse *>(&response);
+    if (readResponse == nullptr) {
+        error("P4RuntimeSmith: Expected a BFRuntime read response, got a %1%.",
+              response.GetDescriptor()->full_name());
+        return false;
+    }
+    // Swap every entity into the same insertion instead of copying it.
+    bfrt_proto::Update update;
+    update.set_type(bfrt_proto::Update_Type::Update_Type_INSERT);
+    for (auto &entity : *readResponse->mutable_entities()) {
+        update.mutable_entity()->Swap(&entity);
+        if (!applyUpdate(update)) {
+            return false;
+        }
+    }
+    return true;
 }
 
-UpdateSeries TofinoTnaFuzzer::produceUpdateTimeSeries() { return {}; }
+bool TofinoTnaFuzzer::applyUpdate(const bfrt_proto::Update &update) {
+    if (!update.entity().has_table_entry()) {
+        return true;
+    }
+    const auto *p4Info = getProgramInfo().getP4RuntimeApi().p4Info;
+    const auto &entry = update.entity().table_entry();
+    auto isDelete = update.type() == bfrt_proto::Update_Type::Update_Type_DELETE;
+    // Insert an entry or replace the installed one with the same key, keeping its position.
+    auto apply = [isDelete, &entry](TableState<bfrt_proto::TableEntry> &state,
+                                    const std::string &key) {
+        if (isDelete) {
+            state.erase(key);
+        } else if (auto *installed = state.find(key)) {
+            *installed = entry;
+        } else {
+            state.insert(key, entry);
+        }
+    };
+    if (const auto *table = P4::ControlPlaneAPI::findP4InfoObject(
+            p4Info->tables().begin(), p4Info->tables().end(), entry.table_id())) {
+        apply(currentState[table->preamble().name()], computeEntryKey(entry));
+        return true;
+    }
+    const auto *profile = P4::ControlPlaneAPI::findP4InfoObject(
+        p4Info->action_profiles().begin(), p4Info->action_profiles().end(), entry.table_id());
+    if (profile == nullptr) {
+        error("P4RuntimeSmith: Unknown table id %1%.", entry.table_id());
+        return false;
+    }
+    // Members always carry an action, groups never do.
+    auto isMember = entry.data().action_id() != 0;
+    auto &stateMap = isMember ? actionProfileMembers : selectorGroups;
+    auto id = getActionProfileObjectId(entry);
+    apply(stateMap[profile->preamble().name()], std::to_string(id));
+    // Ids are not reused, so the next id follows the largest id seen so far.
+    auto &nextIds = isMember ? nextMemberIds : nextGroupIds;
+    auto &nextId = nextIds.try_emplace(profile->preamble().name(), 1).first->second;
+    nextId = std::max(nextId, id + 1);
+    return true;
+}
+
+InitialConfig TofinoTnaFuzzer::produceInitialConfig() {
+    return produceBatchedInitialConfig<bfrt_proto::WriteRequest>(
+        [this](auto &batcher) {
+            produceUpdates(true, batcher, getProgramInfo().getFuzzerConfig().getMaxEntryGenCnt());
+        });
+}
+
+UpdateSeries TofinoTnaFuzzer::produceUpdateSteps(size_t maxSteps) {
+    return produceBatchedUpdateSteps<bfrt_proto::WriteRequest>(
+        maxSteps,
+        [this](auto &batcher, bool insertOnly, uint64_t maxUpdatesPerTable) {
+            produceUpdates(false, batcher, maxUpdatesPerTable, insertOnly);
+        },
+        [this]() { return produceReadRequest(); });
+}
 
 }  // namespace P4::P4Tools::RtSmith::Tna
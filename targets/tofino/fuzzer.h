@@ -11,6 +11,24 @@ class TofinoTnaFuzzer : public RuntimeFuzzer {
     /// @returns the program info associated with the current target.
     [[nodiscard]] const TofinoTnaProgramInfo &getProgramInfo() const override;
 
+ protected:
+    /// The entries currently installed in each table, keyed by the table name.
+    std::map<std::string, TableState<bfrt_proto::TableEntry>> currentState;
+
+    /// The recently deleted entries of each table, keyed by the table name.
+    std::map<std::string, TableState<bfrt_proto::TableEntry>> deletedEntries;
+
+    /// The members of each action profile and the groups of each action selector, keyed by the
+    /// action profile name. Members and groups are keyed by their id. They are never deleted
+    /// because table entries may refer to them.
+    std::map<std::string, TableState<bfrt_proto::TableEntry>> actionProfileMembers;
+    std::map<std::string, TableState<bfrt_proto::TableEntry>> selectorGroups;
+
+    /// The next unused member and group id of each action profile, keyed by the action profile
+    /// name. Ids start at 1 and are not reused.
+    std::map<std::string, uint32_t> nextMemberIds;
+    std::map<std::string, uint32_t> nextGroupIds;
+
  public:
     explicit TofinoTnaFuzzer(const TofinoTnaProgramInfo &programInfo);
 
@@ -21,8 +39,9 @@ class TofinoTnaFuzzer : public RuntimeFuzzer {
 
     /// @brief Produce a `KeyField_LPM` with bitwidth.
     /// @param bitwidth
+    /// @param policy Decides the range of the prefix length.
     /// @return A `KeyField_LPM`.
-    virtual bfrt_proto::KeyField_LPM produceKeyField_LPM(int bitwidth);
+    virtual bfrt_proto::KeyField_LPM produceKeyField_LPM(int bitwidth, const TablePolicy &policy);
 
     /// @brief Produce a `KeyField_Ternary` with bitwidth.
     /// @param bitwidth
@@ -54,20 +73,111 @@ class TofinoTnaFuzzer : public RuntimeFuzzer {
 
     /// @brief Produce a random `KeyField`.
     /// @param match The match field info.
+    /// @param policy The generation policy of the table.
     /// @return A `KeyField`
-    virtual bfrt_proto::KeyField produceKeyField(const p4::config::v1::MatchField &match);
+    virtual bfrt_proto::KeyField produceKeyField(const p4::config::v1::MatchField &match,
+                                                 const TablePolicy &policy);
 
     /// @brief Produce a `TableEntry` for `table` with a randomly selected action.
     /// @param table
     /// @param actions
+    /// @param policy The generation policy of the table.
     /// @return A `TableEntry`.
     bfrt_proto::TableEntry produceTableEntry(
         const p4::config::v1::Table &table,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions,
+        const TablePolicy &policy);
+
+    /// @brief Produce the data of an entry of `table`. Tables with an action profile or an action
+    /// selector refer to an existing member or group, all other tables use a random action.
+    /// @param table
+    /// @param actions
+    /// @return A `TableData`.
+    bfrt_proto::TableData produceEntryData(
+        const p4::config::v1::Table &table,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
+
+    /// @brief Produce a member with a random action for an action profile.
+    /// @param profile
+    /// @param memberId
+    /// @param actionRefs The actions of the tables that use the profile.
+    /// @param actions
+    /// @return The entry of the action profile table.
+    bfrt_proto::TableEntry produceActionProfileMember(
+        const p4::config::v1::ActionProfile &profile, uint32_t memberId,
+        const google::protobuf::RepeatedPtrField<p4::config::v1::ActionRef> &actionRefs,
         const google::protobuf::RepeatedPtrField<p4::config::v1::Action> &actions);
 
+    /// @brief Produce a group of distinct existing members for an action selector. The group size
+    /// is drawn from the configured group size range.
+    /// @param profile
+    /// @param groupId
+    /// @param members The members of the action profile.
+    /// @return The entry of the action selector table.
+    bfrt_proto::TableEntry produceSelectorGroup(
+        const p4::config::v1::ActionProfile &profile, uint32_t groupId,
+        const TableState<bfrt_proto::TableEntry> &members);
+
+    /// @brief Add a member to or remove a member from `group`, keeping its size within the
+    /// configured group size range.
+    /// @param profile
+    /// @param group The entry of the action selector table.
+    /// @param members The members of the action profile.
+    void churnSelectorGroup(const p4::config::v1::ActionProfile &profile,
+                            bfrt_proto::TableEntry &group,
+                            const TableState<bfrt_proto::TableEntry> &members);
+
+    /// @brief Produce the member and group updates of all action profiles and action selectors
+    /// and add them to `batcher`. Members, groups, and the table entries referring to them are
+    /// put into separate requests, so that references are always installed first.
+    /// @param isInitialConfig The initial configuration installs members and groups, updates
+    /// modify the actions of members and the membership of groups.
+    /// @param batcher Packs the updates into `WriteRequest`s.
+    void produceActionProfileUpdates(bool isInitialConfig,
+                                     WriteRequestBatcher<bfrt_proto::WriteRequest> &batcher);
+
+    /// @brief Compute the canonical key of `entry` from its key fields.
+    /// @param entry
+    /// @return The key as a byte string.
+    static std::string computeEntryKey(const bfrt_proto::TableEntry &entry);
+
+    /// @brief Produce the table entry updates of a single time step and add them to `batcher`.
+    /// @param isInitialConfig describes whether the updates are generated in the context of an
+    /// initial configuration (only inserts are used there). Otherwise, modifications and deletions
+    /// target entries that are currently installed. A modification only changes the action data
+    /// of the entry.
+    /// @param batcher Packs the updates into `WriteRequest`s.
+    /// @param maxUpdatesPerTable The maximum number of updates per table.
+    /// @param insertOnly Only insert entries in a time step of an insert-only workload phase.
+    void produceUpdates(bool isInitialConfig,
+                        WriteRequestBatcher<bfrt_proto::WriteRequest> &batcher,
+                        uint64_t maxUpdatesPerTable, bool insertOnly = false);
+
+    /// @brief Produce a `ReadRequest` with a single entity, either a wildcard read of a table or a
+    /// read of an installed table entry.
+    /// @return The request or nullptr if the program has no tables.
+    virtual std::unique_ptr<bfrt_proto::ReadRequest> produceReadRequest();
+
+    /// @brief Apply a single update of a write request to the state of the fuzzer. Updates of an
+    /// action profile table are members, updates of the action selector table without an action
+    /// are groups.
+    /// @param update
+    /// @return False if the update refers to a table that does not exist in the program.
+    virtual bool applyUpdate(const bfrt_proto::Update &update);
+
+    [[nodiscard]] ProtobufMessagePtr produceEmptyWriteRequest() const override;
+
+    [[nodiscard]] ProtobufMessagePtr produceEmptyReadResponse() const override;
+
+    [[nodiscard]] ProtobufMessagePtr produceStateSnapshot() const override;
+
+    bool applyWriteRequest(const google::protobuf::Message &request) override;
+
+    bool applyReadResponse(google::protobuf::Message &response) override;
+
     InitialConfig produceInitialConfig() override;
 
-    UpdateSeries produceUpdateTimeSeries() override;
+    UpdateSeries produceUpdateSteps(size_t maxSteps) override;
 };
 
 }  // namespace P4::P4Tools::RtSmith::Tna
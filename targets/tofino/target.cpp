@@ -36,7 +36,7 @@ MidEnd TofinoTnaRtSmithTarget::mkMidEnd(const CompilerOptions &options) const {
     return midEnd;
 }
 
-const ProgramInfo *TofinoTnaRtSmithTarget::produceProgramInfoImpl(
+std::unique_ptr<ProgramInfo> TofinoTnaRtSmithTarget::produceProgramInfoImpl(
     const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions,
     const IR::Declaration_Instance * /*mainDecl*/) const {
     std::optional<P4::P4RuntimeAPI> p4runtimeApi;
@@ -55,7 +55,8 @@ const ProgramInfo *TofinoTnaRtSmithTarget::produceProgramInfoImpl(
             return nullptr;
         }
     }
-    auto tofinoTnaProgramInfo = new TofinoTnaProgramInfo(compilerResult, p4runtimeApi.value());
+    auto tofinoTnaProgramInfo =
+        std::make_unique<TofinoTnaProgramInfo>(compilerResult, p4runtimeApi.value());
     // Override the fuzzer configurations if a TOML file is provided.
     if (rtSmithOptions.fuzzerConfigPath().has_value())
         tofinoTnaProgramInfo->loadFuzzerConfig(rtSmithOptions.fuzzerConfigPath().value());
@@ -68,8 +69,9 @@ const ProgramInfo *TofinoTnaRtSmithTarget::produceProgramInfoImpl(
     return tofinoTnaProgramInfo;
 }
 
-TofinoTnaFuzzer &TofinoTnaRtSmithTarget::getFuzzerImpl(const ProgramInfo &programInfo) const {
-    return *new TofinoTnaFuzzer(*programInfo.checkedTo<TofinoTnaProgramInfo>());
+std::unique_ptr<RuntimeFuzzer> TofinoTnaRtSmithTarget::produceFuzzerImpl(
+    const ProgramInfo &programInfo) const {
+    return std::make_unique<TofinoTnaFuzzer>(*programInfo.checkedTo<TofinoTnaProgramInfo>());
 }
 
 }  // namespace P4::P4Tools::RtSmith::Tna
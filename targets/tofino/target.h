@@ -1,6 +1,8 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_RTSMITH_TARGETS_TOFINO_TARGET_H_
 #define BACKENDS_P4TOOLS_MODULES_RTSMITH_TARGETS_TOFINO_TARGET_H_
 
+#include <memory>
+
 #include "backends/p4tools/modules/rtsmith/core/program_info.h"
 #include "backends/p4tools/modules/rtsmith/core/target.h"
 #include "backends/p4tools/modules/rtsmith/targets/tofino/fuzzer.h"
@@ -17,11 +19,12 @@ class TofinoTnaRtSmithTarget : public RtSmithTarget {
     static void make();
 
  protected:
-    const ProgramInfo *produceProgramInfoImpl(
+    std::unique_ptr<ProgramInfo> produceProgramInfoImpl(
         const CompilerResult &compilerResult, const RtSmithOptions &rtSmithOptions,
         const IR::Declaration_Instance *mainDecl) const override;
 
-    [[nodiscard]] TofinoTnaFuzzer &getFuzzerImpl(const ProgramInfo &programInfo) const override;
+    [[nodiscard]] std::unique_ptr<RuntimeFuzzer> produceFuzzerImpl(
+        const ProgramInfo &programInfo) const override;
 
     [[nodiscard]] MidEnd mkMidEnd(const CompilerOptions &options) const override;
 };
@@ -0,0 +1,128 @@
+#include "backends/p4tools/modules/rtsmith/core/checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "p4/v1/p4runtime.pb.h"
+#pragma GCC diagnostic pop
+
+#include "backends/p4tools/common/lib/util.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::Checkpoint;
+
+/// @returns a write request with a single insertion into table @param tableId.
+p4::v1::WriteRequest makeRequest(uint32_t tableId) {
+    p4::v1::WriteRequest request;
+    auto *update = request.add_updates();
+    update->set_type(p4::v1::Update_Type::Update_Type_INSERT);
+    update->mutable_entity()->mutable_table_entry()->set_table_id(tableId);
+    return request;
+}
+
+/// @returns an empty checkpoint directory for @param testName.
+std::filesystem::path makeCheckpointDir(const std::string &testName) {
+    auto dir = std::filesystem::temp_directory_path() / ("rtsmith_checkpoint_" + testName);
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+// Loading restores the position, the snapshot, and the journal of the current epoch.
+TEST(CheckpointTest, RestoresSnapshotAndJournal) {
+    auto dir = makeCheckpointDir("restore");
+    {
+        Checkpoint checkpoint(dir, 42, 2);
+        ASSERT_TRUE(checkpoint.startEpoch(makeRequest(1)));
+        ASSERT_TRUE(checkpoint.setTotalSteps(10));
+        ASSERT_TRUE(checkpoint.appendToJournal(makeRequest(2)));
+        EXPECT_FALSE(checkpoint.completeStep(3));
+        ASSERT_TRUE(checkpoint.appendToJournal(makeRequest(3)));
+        // The interval is reached, the next epoch replaces the snapshot and clears the journal.
+        EXPECT_TRUE(checkpoint.completeStep(1));
+        ASSERT_TRUE(checkpoint.startEpoch(makeRequest(4)));
+        ASSERT_TRUE(checkpoint.appendToJournal(makeRequest(5)));
+        EXPECT_FALSE(checkpoint.completeStep(2));
+    }
+
+    Checkpoint checkpoint(dir, 42, 2);
+    std::vector<std::unique_ptr<google::protobuf::Message>> requests;
+    ASSERT_TRUE(checkpoint.load(p4::v1::WriteRequest(), requests));
+    const auto &position = checkpoint.getPosition();
+    EXPECT_EQ(position.epoch, 2U);
+    EXPECT_EQ(position.steps, 3U);
+    EXPECT_EQ(position.requests, 6U);
+    EXPECT_EQ(position.totalSteps, 10U);
+    ASSERT_EQ(requests.size(), 2U);
+    std::vector<uint32_t> tableIds;
+    for (const auto &message : requests) {
+        const auto *request = dynamic_cast<const p4::v1::WriteRequest *>(message.get());
+        ASSERT_NE(request, nullptr);
+        tableIds.push_back(request->updates(0).entity().table_entry().table_id());
+    }
+    EXPECT_EQ(tableIds, std::vector<uint32_t>({4, 5}));
+    std::filesystem::remove_all(dir);
+}
+
+// A compressed checkpoint is restored like an uncompressed one.
+TEST(CheckpointTest, RestoresCompressedCheckpoint) {
+    auto dir = makeCheckpointDir("compressed");
+    {
+        Checkpoint checkpoint(dir, 42, 10, RtSmith::Compression::Gzip);
+        ASSERT_TRUE(checkpoint.startEpoch(makeRequest(1)));
+        ASSERT_TRUE(checkpoint.appendToJournal(makeRequest(2)));
+        ASSERT_TRUE(checkpoint.appendToJournal(makeRequest(3)));
+        EXPECT_FALSE(checkpoint.completeStep(2));
+        ASSERT_TRUE(checkpoint.appendToJournal(makeRequest(4)));
+        EXPECT_FALSE(checkpoint.completeStep(1));
+    }
+
+    Checkpoint checkpoint(dir, 42, 10);
+    std::vector<std::unique_ptr<google::protobuf::Message>> requests;
+    ASSERT_TRUE(checkpoint.load(p4::v1::WriteRequest(), requests));
+    EXPECT_EQ(checkpoint.getPosition().steps, 2U);
+    std::vector<uint32_t> tableIds;
+    for (const auto &message : requests) {
+        const auto *request = dynamic_cast<const p4::v1::WriteRequest *>(message.get());
+        ASSERT_NE(request, nullptr);
+        tableIds.push_back(request->updates(0).entity().table_entry().table_id());
+    }
+    EXPECT_EQ(tableIds, std::vector<uint32_t>({1, 2, 3, 4}));
+    std::filesystem::remove_all(dir);
+}
+
+// Every epoch reseeds the random number generator with a seed derived from the epoch.
+TEST(CheckpointTest, ReseedsPerEpoch) {
+    EXPECT_NE(Checkpoint::deriveSeed(1, 1), Checkpoint::deriveSeed(1, 2));
+    EXPECT_NE(Checkpoint::deriveSeed(1, 1), Checkpoint::deriveSeed(2, 1));
+
+    auto dir = makeCheckpointDir("reseed");
+    Checkpoint checkpoint(dir, 7, 1);
+    ASSERT_TRUE(checkpoint.startEpoch(p4::v1::WriteRequest()));
+    auto first = Utils::getRandInt(1000000);
+    Utils::setRandomSeed(static_cast<int>(Checkpoint::deriveSeed(7, 1)));
+    EXPECT_EQ(Utils::getRandInt(1000000), first);
+    std::filesystem::remove_all(dir);
+}
+
+// Loading fails if the directory does not contain a checkpoint.
+TEST(CheckpointTest, RejectsMissingCheckpoint) {
+    auto dir = makeCheckpointDir("missing");
+    Checkpoint checkpoint(dir, 0, 1);
+    std::vector<std::unique_ptr<google::protobuf::Message>> requests;
+    EXPECT_FALSE(checkpoint.load(p4::v1::WriteRequest(), requests));
+    EXPECT_TRUE(requests.empty());
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,99 @@
+#include "backends/p4tools/modules/rtsmith/core/distributions.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "backends/p4tools/common/lib/util.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::ArrivalProcess;
+using P4::P4Tools::RtSmith::KeyPopularity;
+using P4::P4Tools::RtSmith::StepSize;
+
+constexpr size_t NUM_SAMPLES = 100000;
+
+/// @returns how often each position of a table with @param numEntries entries is sampled.
+std::vector<size_t> countSamples(const KeyPopularity &popularity, size_t numEntries) {
+    std::vector<size_t> counts(numEntries);
+    for (size_t idx = 0; idx < NUM_SAMPLES; idx++) {
+        auto position = popularity.sample(numEntries);
+        EXPECT_LT(position, numEntries);
+        if (position < numEntries) {
+            counts[position]++;
+        }
+    }
+    return counts;
+}
+
+// The frequency of the entry at rank k is proportional to 1 / k^s.
+TEST(KeyPopularityTest, SamplesZipf) {
+    Utils::setRandomSeed(1);
+    constexpr size_t NUM_ENTRIES = 1000;
+    constexpr double EXPONENT = 1.2;
+    auto counts = countSamples(KeyPopularity::zipf(EXPONENT), NUM_ENTRIES);
+    double normalization = 0;
+    for (size_t rank = 1; rank <= NUM_ENTRIES; rank++) {
+        normalization += std::pow(static_cast<double>(rank), -EXPONENT);
+    }
+    for (size_t rank = 1; rank <= 4; rank++) {
+        auto expected = std::pow(static_cast<double>(rank), -EXPONENT) / normalization;
+        auto observed = static_cast<double>(counts[rank - 1]) / NUM_SAMPLES;
+        EXPECT_NEAR(observed, expected, 0.01);
+    }
+    EXPECT_GT(counts[0], counts[1]);
+    EXPECT_GT(counts[1], counts[9]);
+}
+
+// The hot set receives the configured share of the samples, also for a single entry.
+TEST(KeyPopularityTest, SamplesHotCold) {
+    Utils::setRandomSeed(1);
+    auto counts = countSamples(KeyPopularity::hotCold(0.1, 0.9), 100);
+    size_t hotCount = 0;
+    for (size_t position = 0; position < 10; position++) {
+        hotCount += counts[position];
+    }
+    EXPECT_NEAR(static_cast<double>(hotCount) / NUM_SAMPLES, 0.9, 0.01);
+    EXPECT_EQ(countSamples(KeyPopularity::hotCold(0.1, 0.9), 1)[0], NUM_SAMPLES);
+    EXPECT_EQ(countSamples(KeyPopularity::zipf(1.0), 1)[0], NUM_SAMPLES);
+}
+
+// Poisson delays have the mean 1 / rate, geometric step sizes have the configured mean.
+TEST(WorkloadTest, SamplesPoissonAndGeometric) {
+    Utils::setRandomSeed(1);
+    auto poisson = ArrivalProcess::poisson(1000);
+    auto geometric = StepSize::geometric(4);
+    double delaySum = 0;
+    double sizeSum = 0;
+    for (size_t idx = 0; idx < NUM_SAMPLES; idx++) {
+        delaySum += static_cast<double>(poisson.sampleDelay(idx, NUM_SAMPLES));
+        auto size = geometric.sample();
+        EXPECT_GE(size, 1U);
+        sizeSum += static_cast<double>(size);
+    }
+    EXPECT_NEAR(delaySum / NUM_SAMPLES, 1000, 20);
+    EXPECT_NEAR(sizeSum / NUM_SAMPLES, 4, 0.1);
+}
+
+// Deterministic processes produce their delays by position.
+TEST(WorkloadTest, ProducesOnOffAndRampDelays) {
+    auto onOff = ArrivalProcess::onOff(3, 10, 1000);
+    EXPECT_EQ(onOff.sampleDelay(0, 6), 1000U);
+    EXPECT_EQ(onOff.sampleDelay(1, 6), 10U);
+    EXPECT_EQ(onOff.sampleDelay(2, 6), 10U);
+    EXPECT_EQ(onOff.sampleDelay(3, 6), 1000U);
+    auto ramp = ArrivalProcess::ramp(100, 0);
+    EXPECT_EQ(ramp.sampleDelay(0, 5), 100U);
+    EXPECT_EQ(ramp.sampleDelay(2, 5), 50U);
+    EXPECT_EQ(ramp.sampleDelay(4, 5), 0U);
+    EXPECT_EQ(ramp.sampleDelay(0, 1), 100U);
+    EXPECT_EQ(StepSize::fixed(7).sample(), 7U);
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
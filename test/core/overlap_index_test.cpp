@@ -0,0 +1,54 @@
+#include "backends/p4tools/modules/rtsmith/core/overlap_index.h"
+
+#include <gtest/gtest.h>
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::EntryRegion;
+using P4::P4Tools::RtSmith::FieldRegion;
+using P4::P4Tools::RtSmith::OverlapIndex;
+
+// Ternary entries overlap if they agree on all bits both of them care about.
+TEST(OverlapIndexTest, CountsTernaryOverlaps) {
+    OverlapIndex index({FieldRegion::Kind::Masked}, {8});
+    // 0b1010****
+    EXPECT_EQ(index.insert("a", {FieldRegion::masked(0xA0, 0xF0)}), 0U);
+    // 0b****0101 overlaps with a.
+    EXPECT_EQ(index.insert("b", {FieldRegion::masked(0x05, 0x0F)}), 1U);
+    // 0b0******* overlaps with b only.
+    EXPECT_EQ(index.insert("c", {FieldRegion::masked(0x00, 0x80)}), 1U);
+    EXPECT_DOUBLE_EQ(index.averageOverlapDegree(), 4.0 / 3.0);
+    // A full wildcard overlaps with everything.
+    EXPECT_EQ(index.countOverlaps({FieldRegion::masked(0, 0)}), 3U);
+
+    EXPECT_TRUE(index.erase("b"));
+    EXPECT_FALSE(index.erase("b"));
+    EXPECT_EQ(index.size(), 2U);
+    EXPECT_DOUBLE_EQ(index.averageOverlapDegree(), 0.0);
+}
+
+// Entries only overlap if all of their key fields overlap.
+TEST(OverlapIndexTest, CountsRangeOverlapsAcrossFields) {
+    OverlapIndex index({FieldRegion::Kind::Masked, FieldRegion::Kind::Interval}, {8, 16});
+    EXPECT_EQ(index.insert("a", {FieldRegion::masked(1, 0xFF), FieldRegion::interval(10, 20)}),
+              0U);
+    EXPECT_EQ(index.insert("b", {FieldRegion::masked(1, 0xFF), FieldRegion::interval(20, 30)}),
+              1U);
+    // Overlaps in the range but not in the exact field.
+    EXPECT_EQ(index.insert("c", {FieldRegion::masked(2, 0xFF), FieldRegion::interval(0, 100)}),
+              0U);
+    EXPECT_EQ(index.insert("d", {FieldRegion::masked(0, 0), FieldRegion::interval(15, 25)}), 3U);
+    EXPECT_EQ(index.countOverlaps({FieldRegion::masked(1, 0xFF), FieldRegion::interval(30, 40)}),
+              1U);
+
+    // Re-inserting a key replaces the entry.
+    EXPECT_EQ(index.insert("d", {FieldRegion::masked(3, 0xFF), FieldRegion::interval(15, 25)}), 0U);
+    EXPECT_EQ(index.size(), 4U);
+    EXPECT_DOUBLE_EQ(index.averageOverlapDegree(), 0.5);
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
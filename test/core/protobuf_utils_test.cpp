@@ -0,0 +1,172 @@
+#include "backends/p4tools/modules/rtsmith/core/control_plane/protobuf_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/util/delimited_message_util.h>
+
+#include "p4/v1/p4runtime.pb.h"
+#pragma GCC diagnostic pop
+
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::compressGzip;
+using P4::P4Tools::RtSmith::isGzip;
+using P4::P4Tools::RtSmith::Protobuf::deserializeObjectFromFile;
+using P4::P4Tools::RtSmith::Protobuf::MessageFormat;
+using P4::P4Tools::RtSmith::Protobuf::parseAnyMessageFromFile;
+using P4::P4Tools::RtSmith::Protobuf::parseMessageFromFile;
+
+/// @returns a write request with a single insertion into table @param tableId.
+p4::v1::WriteRequest makeRequest(uint32_t tableId) {
+    p4::v1::WriteRequest request;
+    request.set_device_id(1);
+    auto *update = request.add_updates();
+    update->set_type(p4::v1::Update_Type::Update_Type_INSERT);
+    update->mutable_entity()->mutable_table_entry()->set_table_id(tableId);
+    return request;
+}
+
+/// Write @param content to the file @param name in the temporary directory.
+/// @returns the path of the file.
+std::filesystem::path writeFile(const std::string &name, const std::string &content) {
+    auto path = std::filesystem::temp_directory_path() / ("rtsmith_protobuf_" + name);
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output << content;
+    return path;
+}
+
+// Text, binary, and length-delimited files are detected and parsed.
+TEST(ProtobufUtilsTest, DetectsFormats) {
+    auto request = makeRequest(7);
+
+    std::string text;
+    ASSERT_TRUE(google::protobuf::TextFormat::PrintToString(request, &text));
+    p4::v1::WriteRequest parsed;
+    EXPECT_EQ(parseMessageFromFile(writeFile("text.txtpb", text), parsed), MessageFormat::Text);
+    EXPECT_EQ(parsed.SerializeAsString(), request.SerializeAsString());
+
+    parsed.Clear();
+    EXPECT_EQ(parseMessageFromFile(writeFile("binary.binpb", request.SerializeAsString()), parsed),
+              MessageFormat::Binary);
+    EXPECT_EQ(parsed.SerializeAsString(), request.SerializeAsString());
+
+    // Length-delimited messages are merged.
+    std::string delimited;
+    {
+        google::protobuf::io::StringOutputStream output(&delimited);
+        ASSERT_TRUE(google::protobuf::util::SerializeDelimitedToZeroCopyStream(request, &output));
+        ASSERT_TRUE(
+            google::protobuf::util::SerializeDelimitedToZeroCopyStream(makeRequest(8), &output));
+    }
+    parsed.Clear();
+    EXPECT_EQ(parseMessageFromFile(writeFile("delimited.binpb", delimited), parsed),
+              MessageFormat::LengthDelimited);
+    ASSERT_EQ(parsed.updates_size(), 2);
+    EXPECT_EQ(parsed.updates(1).entity().table_entry().table_id(), 8U);
+}
+
+// A binary message of printable characters that also happens to be framed like length-delimited
+// messages is still parsed as a single binary message.
+TEST(ProtobufUtilsTest, ParsesPrintableBinaryMessages) {
+    p4::v1::WriteRequest request;
+    // The tag of the role and its length, read as a length prefix, frame the whole message. The
+    // framed part starts with the role tag with a wrong wire type, an unknown field.
+    request.set_role(std::string(8, 'a') + "2'" + std::string(39, 'b'));
+    auto binary = request.SerializeAsString();
+    ASSERT_EQ(binary.size(), 51U);
+    ASSERT_EQ(static_cast<unsigned char>(binary.front()), binary.size() - 1);
+
+    p4::v1::WriteRequest parsed;
+    EXPECT_EQ(parseMessageFromFile(writeFile("printable.binpb", binary), parsed),
+              MessageFormat::Binary);
+    EXPECT_EQ(parsed.role(), request.role());
+}
+
+// A text file with a misspelled field name is rejected, although its bytes happen to parse as a
+// binary message of unknown fields.
+TEST(ProtobufUtilsTest, RejectsMalformedTextThatParsesAsUnknownFields) {
+    const std::string text = "arole: 1\n";
+    p4::v1::WriteRequest unknown;
+    ASSERT_TRUE(unknown.ParseFromString(text));
+    ASSERT_FALSE(unknown.GetReflection()->GetUnknownFields(unknown).empty());
+
+    p4::v1::WriteRequest parsed;
+    EXPECT_FALSE(parseMessageFromFile(writeFile("misspelled.txtpb", text), parsed).has_value());
+}
+
+// Gzip-compressed files are decompressed before their format is detected.
+TEST(ProtobufUtilsTest, DecompressesGzipFiles) {
+    auto request = makeRequest(7);
+    std::string text;
+    ASSERT_TRUE(google::protobuf::TextFormat::PrintToString(request, &text));
+    // Concatenated gzip members are a single file.
+    auto compressed = compressGzip(text.substr(0, 10)) + compressGzip(text.substr(10));
+    ASSERT_TRUE(isGzip(compressed));
+    p4::v1::WriteRequest parsed;
+    EXPECT_EQ(parseMessageFromFile(writeFile("text.txtpb.gz", compressed), parsed),
+              MessageFormat::Text);
+    EXPECT_EQ(parsed.SerializeAsString(), request.SerializeAsString());
+
+    auto binary = deserializeObjectFromFile<p4::v1::WriteRequest>(
+        writeFile("binary.binpb.gz", compressGzip(request.SerializeAsString())));
+    ASSERT_TRUE(binary.has_value());
+    EXPECT_EQ(binary->SerializeAsString(), request.SerializeAsString());
+}
+
+// Empty files are empty text messages, missing and malformed files are errors.
+TEST(ProtobufUtilsTest, HandlesEmptyMissingAndMalformedFiles) {
+    auto empty = deserializeObjectFromFile<p4::v1::WriteRequest>(writeFile("empty.txtpb", ""));
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_EQ(empty->updates_size(), 0);
+
+    EXPECT_FALSE(deserializeObjectFromFile<p4::v1::WriteRequest>(
+                     std::filesystem::temp_directory_path() / "rtsmith_protobuf_missing.txtpb")
+                     .has_value());
+    EXPECT_FALSE(deserializeObjectFromFile<p4::v1::WriteRequest>(
+                     writeFile("malformed.txtpb", "updates { not_a_field: 1 }"))
+                     .has_value());
+}
+
+// The message type of a file is picked by its first text field or its unknown binary fields.
+TEST(ProtobufUtilsTest, PicksTheMessageType) {
+    auto request = makeRequest(7);
+    p4::v1::ReadResponse response;
+    *response.add_entities() = request.updates(0).entity();
+
+    std::string text;
+    ASSERT_TRUE(google::protobuf::TextFormat::PrintToString(response, &text));
+    p4::v1::WriteRequest parsedRequest;
+    p4::v1::ReadResponse parsedResponse;
+    EXPECT_EQ(parseAnyMessageFromFile(writeFile("response.txtpb", "# A dump.\n" + text),
+                                      {&parsedRequest, &parsedResponse}),
+              1U);
+    EXPECT_EQ(parsedResponse.SerializeAsString(), response.SerializeAsString());
+
+    parsedResponse.Clear();
+    EXPECT_EQ(parseAnyMessageFromFile(writeFile("response.binpb", response.SerializeAsString()),
+                                      {&parsedRequest, &parsedResponse}),
+              1U);
+    EXPECT_EQ(parsedResponse.SerializeAsString(), response.SerializeAsString());
+
+    EXPECT_EQ(parseAnyMessageFromFile(writeFile("request.binpb", request.SerializeAsString()),
+                                      {&parsedRequest, &parsedResponse}),
+              0U);
+    EXPECT_EQ(parsedRequest.SerializeAsString(), request.SerializeAsString());
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
@@ -1,3 +1,8 @@
+#include "backends/p4tools/modules/rtsmith/session.h"
+
+#include <filesystem>
+#include <fstream>
+
 #include "backends/p4tools/modules/rtsmith/test/core/rtsmith_test.h"
 
 namespace P4::P4Tools::Test {
@@ -40,6 +45,264 @@ TEST_F(P4RuntimeApiTest, GeneratesATestViaTheApi) {
     ASSERT_TRUE(rtSmithResultOpt.has_value());
 }
 
+// A session compiles the program once and reproduces its configurations after a reset.
+TEST_F(P4RuntimeApiTest, SessionReproducesConfigurationsAfterReset) {
+    auto source = generateTestProgram(R"(
+    action acl_drop() {
+        mark_to_drop(sm);
+    }
+
+    table drop_table {
+        key = {
+            hdr.eth_hdr.dst_addr : ternary @name("dst_eth");
+        }
+        actions = {
+            acl_drop();
+            @defaultonly NoAction();
+        }
+    }
+
+    apply {
+        drop_table.apply();
+    })");
+    auto autoContext = SetUp("bmv2", "v1model");
+    auto &rtSmithOptions = RtSmith::RtSmithOptions::get();
+    rtSmithOptions.target = "bmv2"_cs;
+    rtSmithOptions.arch = "v1model"_cs;
+    auto session = RtSmith::RtSmithSession::create(source, rtSmithOptions);
+    ASSERT_TRUE(session.has_value());
+
+    auto serialize = [](const auto &messages) {
+        std::vector<std::string> result;
+        for (const auto &message : messages) {
+            result.push_back(message->SerializeAsString());
+        }
+        return result;
+    };
+    auto serializeSeries = [](const RtSmith::UpdateSeries &updateSeries) {
+        std::vector<std::string> result;
+        for (const auto &[microseconds, message] : updateSeries) {
+            result.push_back(std::to_string(microseconds) + message->SerializeAsString());
+        }
+        return result;
+    };
+
+    session->reset(1);
+    auto initialConfig = serialize(session->initialConfig());
+    auto updates = serializeSeries(session->nextUpdates(2));
+    session->reset(1);
+    EXPECT_EQ(serialize(session->initialConfig()), initialConfig);
+    EXPECT_EQ(serializeSeries(session->nextUpdates(2)), updates);
+}
+
+// Pulling the update series one request at a time produces the same series as producing it at once.
+TEST_F(P4RuntimeApiTest, PullsTheUpdateSeriesOneRequestAtATime) {
+    auto source = generateTestProgram(R"(
+    action acl_drop() {
+        mark_to_drop(sm);
+    }
+
+    table drop_table {
+        key = {
+            hdr.eth_hdr.dst_addr : ternary @name("dst_eth");
+        }
+        actions = {
+            acl_drop();
+            @defaultonly NoAction();
+        }
+    }
+
+    apply {
+        drop_table.apply();
+    })");
+    auto autoContext = SetUp("bmv2", "v1model");
+    auto &rtSmithOptions = RtSmith::RtSmithOptions::get();
+    rtSmithOptions.target = "bmv2"_cs;
+    rtSmithOptions.arch = "v1model"_cs;
+    auto session = RtSmith::RtSmithSession::create(source, rtSmithOptions);
+    ASSERT_TRUE(session.has_value());
+
+    session->reset(1);
+    session->initialConfig();
+    std::vector<std::string> updates;
+    for (const auto &[microseconds, message] : session->nextUpdates(SIZE_MAX)) {
+        updates.push_back(std::to_string(microseconds) + message->SerializeAsString());
+    }
+
+    session->reset(1);
+    session->initialConfig();
+    std::vector<std::string> pulledUpdates;
+    while (auto update = session->nextUpdate()) {
+        pulledUpdates.push_back(std::to_string(update->first) +
+                                update->second->SerializeAsString());
+    }
+    EXPECT_EQ(pulledUpdates, updates);
+
+    // The consumer stops the series early, the remaining requests are not produced.
+    session->reset(1);
+    session->initialConfig();
+    auto numUpdates = session->getFuzzer().forEachUpdate(
+        [](uint64_t /*microseconds*/, RtSmith::ProtobufMessagePtr /*request*/) { return false; });
+    EXPECT_EQ(numUpdates, updates.empty() ? 0U : 1U);
+}
+
+// Tables with an action selector must refer to members or groups or use one-shot action sets.
+TEST_F(P4RuntimeApiTest, LoadsAnInitialStateDump) {
+    auto source = generateTestProgram(R"(
+    action acl_drop() {
+        mark_to_drop(sm);
+    }
+
+    table drop_table {
+        key = {
+            hdr.eth_hdr.dst_addr : ternary @name("dst_eth");
+        }
+        actions = {
+            acl_drop();
+            @defaultonly NoAction();
+        }
+    }
+
+    apply {
+        drop_table.apply();
+    })");
+    auto autoContext = SetUp("bmv2", "v1model");
+    auto &rtSmithOptions = RtSmith::RtSmithOptions::get();
+    rtSmithOptions.target = "bmv2"_cs;
+    rtSmithOptions.arch = "v1model"_cs;
+    auto session = RtSmith::RtSmithSession::create(source, rtSmithOptions);
+    ASSERT_TRUE(session.has_value());
+
+    session->reset(1);
+    session->initialConfig();
+    auto snapshot = session->getFuzzer().produceStateSnapshot();
+    const auto &writeRequest = dynamic_cast<const p4::v1::WriteRequest &>(*snapshot);
+    ASSERT_GT(writeRequest.updates_size(), 0);
+
+    // A binary write request dump restores the same state.
+    auto writeRequestPath = std::filesystem::temp_directory_path() / "rtsmith_state.binpb";
+    {
+        std::ofstream output(writeRequestPath, std::ios::binary | std::ios::trunc);
+        output << writeRequest.SerializeAsString();
+    }
+    session->reset(2);
+    ASSERT_TRUE(session->getFuzzer().loadInitialState(writeRequestPath));
+    EXPECT_EQ(session->getFuzzer().produceStateSnapshot()->SerializeAsString(),
+              writeRequest.SerializeAsString());
+
+    // So does a text read response dump.
+    p4::v1::ReadResponse readResponse;
+    for (const auto &update : writeRequest.updates()) {
+        *readResponse.add_entities() = update.entity();
+    }
+    auto readResponsePath = std::filesystem::temp_directory_path() / "rtsmith_state.txtpb";
+    {
+        std::ofstream output(readResponsePath, std::ios::trunc);
+        output << readResponse.DebugString();
+    }
+    session->reset(2);
+    ASSERT_TRUE(session->getFuzzer().loadInitialState(readResponsePath));
+    EXPECT_EQ(session->getFuzzer().produceStateSnapshot()->SerializeAsString(),
+              writeRequest.SerializeAsString());
+}
+
+TEST_F(P4RuntimeApiTest, GeneratesActionSelectorEntities) {
+    auto source = generateTestProgram(R"(
+    action set_port(bit<9> port) {
+        sm.egress_spec = port;
+    }
+
+    table ecmp_table {
+        key = {
+            hdr.eth_hdr.dst_addr : exact @name("dst_eth");
+            hdr.eth_hdr.src_addr : selector @name("src_eth");
+        }
+        actions = {
+            set_port();
+            @defaultonly NoAction();
+        }
+        implementation = action_selector(HashAlgorithm.crc16, 32w128, 32w16);
+    }
+
+    apply {
+        ecmp_table.apply();
+    })");
+    auto autoContext = SetUp("bmv2", "v1model");
+    auto &rtSmithOptions = RtSmith::RtSmithOptions::get();
+    rtSmithOptions.target = "bmv2"_cs;
+    rtSmithOptions.arch = "v1model"_cs;
+    auto rtSmithResultOpt = P4::P4Tools::RtSmith::RtSmith::generateConfig(source, rtSmithOptions);
+    ASSERT_TRUE(rtSmithResultOpt.has_value());
+
+    int memberCount = 0;
+    for (const auto &message : rtSmithResultOpt.value().config) {
+        const auto *request = dynamic_cast<const p4::v1::WriteRequest *>(message.get());
+        ASSERT_TRUE(request != nullptr);
+        for (const auto &update : request->updates()) {
+            const auto &entity = update.entity();
+            if (entity.has_action_profile_member()) {
+                memberCount++;
+            } else if (entity.has_action_profile_group()) {
+                const auto &group = entity.action_profile_group();
+                EXPECT_GE(group.members_size(), 1);
+                EXPECT_LE(group.members_size(), group.max_size());
+                for (const auto &member : group.members()) {
+                    EXPECT_LE(member.member_id(), static_cast<uint32_t>(memberCount));
+                }
+            } else if (entity.has_table_entry()) {
+                EXPECT_FALSE(entity.table_entry().action().has_action());
+            }
+        }
+    }
+}
+
+// Indexed resources must only be modified, at indices below their declared size.
+TEST_F(P4RuntimeApiTest, GeneratesResourceEntities) {
+    auto source = generateTestProgram(R"(
+    counter<bit<6>>(32w64, CounterType.packets) port_counter;
+    meter<bit<6>>(32w64, MeterType.bytes) port_meter;
+    register<bit<32>, bit<6>>(32w64) port_register;
+    bit<2> color;
+
+    apply {
+        port_counter.count((bit<6>)sm.ingress_port);
+        port_meter.execute_meter((bit<6>)sm.ingress_port, color);
+        port_register.write((bit<6>)sm.ingress_port, (bit<32>)color);
+    })");
+    auto autoContext = SetUp("bmv2", "v1model");
+    auto &rtSmithOptions = RtSmith::RtSmithOptions::get();
+    rtSmithOptions.target = "bmv2"_cs;
+    rtSmithOptions.arch = "v1model"_cs;
+    auto rtSmithResultOpt = P4::P4Tools::RtSmith::RtSmith::generateConfig(source, rtSmithOptions);
+    ASSERT_TRUE(rtSmithResultOpt.has_value());
+
+    int resourceCount = 0;
+    for (const auto &message : rtSmithResultOpt.value().config) {
+        const auto *request = dynamic_cast<const p4::v1::WriteRequest *>(message.get());
+        ASSERT_TRUE(request != nullptr);
+        for (const auto &update : request->updates()) {
+            const auto &entity = update.entity();
+            if (entity.has_counter_entry()) {
+                EXPECT_LT(entity.counter_entry().index().index(), 64);
+                EXPECT_EQ(entity.counter_entry().data().packet_count(), 0);
+            } else if (entity.has_meter_entry()) {
+                EXPECT_LT(entity.meter_entry().index().index(), 64);
+                const auto &config = entity.meter_entry().config();
+                EXPECT_GE(config.pir(), config.cir());
+                EXPECT_GE(config.pburst(), config.cburst());
+            } else if (entity.has_register_entry()) {
+                EXPECT_LT(entity.register_entry().index().index(), 64);
+                EXPECT_LE(entity.register_entry().data().bitstring().size(), 4U);
+            } else {
+                continue;
+            }
+            EXPECT_EQ(update.type(), p4::v1::Update_Type::Update_Type_MODIFY);
+            resourceCount++;
+        }
+    }
+    EXPECT_GT(resourceCount, 0);
+}
+
 }  // anonymous namespace
 
 }  // namespace P4::P4Tools::Test
@@ -53,7 +53,7 @@ TEST_F(TOMLFuzzerConfigurationTest, OverrideFuzzerConfigurationsViaTOMLFile) {
     // Check if the `compilerResult` object is generated successfully.
     ASSERT_TRUE(compilerResult.has_value());
 
-    const auto *programInfo = P4::P4Tools::RtSmith::RtSmithTarget::produceProgramInfo(
+    auto programInfo = P4::P4Tools::RtSmith::RtSmithTarget::produceProgramInfo(
         compilerResult.value(), rtSmithOptions);
     // Check if the `programInfo` object is generated successfully.
     ASSERT_TRUE(programInfo != nullptr);
@@ -141,6 +141,78 @@ TEST_F(TOMLFuzzerConfigurationTest, OverrideFuzzerConfigurationsViaTOMLFile) {
     } else {
         FAIL() << "ControlPlaneSmith: The minimum wait time must be an integer.";
     }
+
+    const auto &tablePolicies = fuzzerConfig.getTablePolicies();
+    if (const auto overlapTargetsValue =
+            P4::P4Tools::RtSmith::TOMLUtils::getAndCastTOMLNode<std::map<std::string, double>>(
+                tomlConfig, "overlapTargets")) {
+        for (const auto &[tableName, overlapTarget] : overlapTargetsValue.value()) {
+            ASSERT_EQ(tablePolicies.count(tableName), 1U);
+            ASSERT_DOUBLE_EQ(tablePolicies.at(tableName).overlapTarget.value_or(-1), overlapTarget);
+        }
+    } else {
+        FAIL() << "ControlPlaneSmith: The overlap targets must be a table mapping table names to "
+                  "numbers.";
+    }
+
+    // The table policy keeps the overlap target of the table.
+    ASSERT_EQ(tablePolicies.size(), 1U);
+    const auto &dropTablePolicy = tablePolicies.at("ingress.drop_table");
+    ASSERT_TRUE(dropTablePolicy.enabled);
+    ASSERT_EQ(dropTablePolicy.entryCount.value_or(0), 20U);
+    ASSERT_DOUBLE_EQ(dropTablePolicy.fillRatio, 0.5);
+    ASSERT_FALSE(dropTablePolicy.insertWeight.has_value());
+    ASSERT_EQ(dropTablePolicy.deleteWeight.value_or(1), 0U);
+    ASSERT_DOUBLE_EQ(dropTablePolicy.wildcardProbability, 0.25);
+    ASSERT_DOUBLE_EQ(dropTablePolicy.weight.value_or(0), 2.5);
+    ASSERT_EQ(fuzzerConfig.getTableWeighting(), RtSmith::TableWeighting::Size);
+
+    for (const auto *weightName : {"insertWeight", "modifyWeight", "deleteWeight"}) {
+        if (!P4::P4Tools::RtSmith::TOMLUtils::getAndCastTOMLNode<uint64_t>(tomlConfig,
+                                                                           weightName)) {
+            FAIL() << "ControlPlaneSmith: The update weights must be integers.";
+        }
+    }
+    ASSERT_EQ(fuzzerConfig.getInsertWeight(), 20U);
+    ASSERT_EQ(fuzzerConfig.getModifyWeight(), 70U);
+    ASSERT_EQ(fuzzerConfig.getDeleteWeight(), 10U);
+
+    if (const auto maxUpdatesPerRequestValue =
+            P4::P4Tools::RtSmith::TOMLUtils::getAndCastTOMLNode<size_t>(tomlConfig,
+                                                                        "maxUpdatesPerRequest")) {
+        ASSERT_EQ(fuzzerConfig.getMaxUpdatesPerRequest(), maxUpdatesPerRequestValue.value());
+    } else {
+        FAIL() << "ControlPlaneSmith: The maximum number of updates per request must be an "
+                  "integer.";
+    }
+    if (const auto maxBytesPerRequestValue =
+            P4::P4Tools::RtSmith::TOMLUtils::getAndCastTOMLNode<size_t>(tomlConfig,
+                                                                        "maxBytesPerRequest")) {
+        ASSERT_EQ(fuzzerConfig.getMaxBytesPerRequest(), maxBytesPerRequestValue.value());
+    } else {
+        FAIL() << "ControlPlaneSmith: The maximum size of a request must be an integer.";
+    }
+
+    ASSERT_EQ(fuzzerConfig.getMaxActionProfileMembers(), 16);
+    ASSERT_EQ(fuzzerConfig.getMaxSelectorGroups(), 8);
+    ASSERT_EQ(fuzzerConfig.getMinGroupSize(), 2);
+    ASSERT_EQ(fuzzerConfig.getMaxGroupSize(), 6);
+    ASSERT_EQ(fuzzerConfig.getMaxMemberWeight(), 3);
+    ASSERT_EQ(fuzzerConfig.getMaxMulticastGroups(), 8);
+    ASSERT_EQ(fuzzerConfig.getMaxCloneSessions(), 2);
+    ASSERT_EQ(fuzzerConfig.getMinReplicas(), 2);
+    ASSERT_EQ(fuzzerConfig.getMaxReplicas(), 5);
+    ASSERT_DOUBLE_EQ(fuzzerConfig.getReadRatio(), 0.5);
+    ASSERT_EQ(fuzzerConfig.getKeyPopularity().getKind(), RtSmith::KeyPopularity::Kind::HotCold);
+    ASSERT_DOUBLE_EQ(fuzzerConfig.getReinsertProbability(), 0.25);
+    const auto &workloadPhases = fuzzerConfig.getWorkloadPhases();
+    ASSERT_EQ(workloadPhases.size(), 2U);
+    ASSERT_EQ(workloadPhases[0].numSteps, 2U);
+    ASSERT_TRUE(workloadPhases[0].insertOnly);
+    ASSERT_EQ(workloadPhases[0].stepSize.sample(), 50U);
+    ASSERT_EQ(workloadPhases[1].arrivalProcess.getKind(),
+              RtSmith::ArrivalProcess::Kind::Poisson);
+    ASSERT_EQ(workloadPhases[1].stepSize.getKind(), RtSmith::StepSize::Kind::Geometric);
 }
 
 // Test of overriding fuzzer configurations via the string representation of the configurations of
@@ -196,7 +268,7 @@ TEST_F(TOMLFuzzerConfigurationTest, OverrideFuzzerConfigurationsViaTOMLString) {
     // Check if the `compilerResult` object is generated successfully.
     ASSERT_TRUE(compilerResult.has_value());
 
-    const auto *programInfo = P4::P4Tools::RtSmith::RtSmithTarget::produceProgramInfo(
+    auto programInfo = P4::P4Tools::RtSmith::RtSmithTarget::produceProgramInfo(
         compilerResult.value(), rtSmithOptions);
     // Check if the `programInfo` object is generated successfully.
     ASSERT_TRUE(programInfo != nullptr);
@@ -284,6 +356,94 @@ TEST_F(TOMLFuzzerConfigurationTest, OverrideFuzzerConfigurationsViaTOMLString) {
     } else {
         FAIL() << "ControlPlaneSmith: The minimum wait time must be an integer.";
     }
+
+    // Without explicit update weights, the threshold for deletion splits the operations on
+    // installed entries between modifications and deletions.
+    ASSERT_EQ(fuzzerConfig.getInsertWeight(), 50U);
+    ASSERT_EQ(fuzzerConfig.getModifyWeight(), 25U);
+    ASSERT_EQ(fuzzerConfig.getDeleteWeight(), 25U);
+}
+
+// Table policies disable tables and shape the match fields of the entries of a table.
+TEST_F(TOMLFuzzerConfigurationTest, AppliesTablePolicies) {
+    auto source = generateTestProgram(R"(
+    action acl_drop() {
+        mark_to_drop(sm);
+    }
+
+    table drop_table {
+        key = {
+            hdr.eth_hdr.dst_addr : ternary @name("dst_eth");
+        }
+        actions = {
+            acl_drop();
+            @defaultonly NoAction();
+        }
+    }
+
+    table fwd_table {
+        key = {
+            hdr.eth_hdr.dst_addr : exact @name("dst_eth");
+            hdr.eth_hdr.src_addr : ternary @name("src_eth");
+        }
+        actions = {
+            acl_drop();
+            @defaultonly NoAction();
+        }
+    }
+
+    apply {
+        drop_table.apply();
+        fwd_table.apply();
+    })");
+    auto autoContext = SetUp("bmv2", "v1model");
+    auto &rtSmithOptions = RtSmith::RtSmithOptions::get();
+    rtSmithOptions.target = "bmv2"_cs;
+    rtSmithOptions.arch = "v1model"_cs;
+    // Policies refer to tables by their fully qualified name or by their alias.
+    rtSmithOptions.setFuzzerConfigString(R"(
+    maxEntryGenCnt = 10
+    maxAttempts = 200
+    maxTables = 10
+    tablesToSkip = []
+    thresholdForDeletion = 50
+    maxUpdateCount = 20
+    maxUpdateTimeInMicroseconds = 100001
+    minUpdateTimeInMicroseconds = 50001
+
+    [tables.drop_table]
+    enabled = false
+
+    [tables."ingress.fwd_table"]
+    entryCount = 8
+    wildcardProbability = 1.0
+    )");
+
+    auto rtSmithResultOpt = P4::P4Tools::RtSmith::RtSmith::generateConfig(source, rtSmithOptions);
+    ASSERT_TRUE(rtSmithResultOpt.has_value());
+
+    std::vector<const google::protobuf::Message *> requests;
+    for (const auto &message : rtSmithResultOpt.value().config) {
+        requests.push_back(message.get());
+    }
+    for (const auto &[microseconds, message] : rtSmithResultOpt.value().updateSeries) {
+        requests.push_back(message.get());
+    }
+    for (const auto *message : requests) {
+        const auto *request = dynamic_cast<const p4::v1::WriteRequest *>(message);
+        if (request == nullptr) {
+            continue;
+        }
+        for (const auto &update : request->updates()) {
+            if (!update.entity().has_table_entry()) {
+                continue;
+            }
+            const auto &entry = update.entity().table_entry();
+            // Only the exact field of the entries of fwd_table remains, drop_table is disabled.
+            ASSERT_EQ(entry.match_size(), 1);
+            EXPECT_TRUE(entry.match(0).has_exact());
+        }
+    }
 }
 
 }  // anonymous namespace
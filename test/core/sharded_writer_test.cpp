@@ -0,0 +1,158 @@
+#include "backends/p4tools/modules/rtsmith/core/sharded_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include <google/protobuf/text_format.h>
+
+#include "p4/v1/p4runtime.pb.h"
+#pragma GCC diagnostic pop
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::ShardedConfigWriter;
+using P4::P4Tools::RtSmith::ShardingPolicy;
+
+/// @returns an initial configuration with action profile members followed by table entries that
+/// alternate between tables 1 and 2. The requests are split after the fourth table entry.
+std::vector<std::unique_ptr<google::protobuf::Message>> makeConfig() {
+    std::vector<std::unique_ptr<google::protobuf::Message>> config;
+    auto request = std::make_unique<p4::v1::WriteRequest>();
+    request->set_device_id(1);
+    for (uint32_t idx = 0; idx < 3; ++idx) {
+        auto *member = request->add_updates()->mutable_entity()->mutable_action_profile_member();
+        member->set_action_profile_id(5);
+        member->set_member_id(idx);
+    }
+    for (uint32_t idx = 0; idx < 8; ++idx) {
+        if (idx == 4) {
+            config.push_back(std::move(request));
+            request = std::make_unique<p4::v1::WriteRequest>();
+            request->set_device_id(1);
+        }
+        auto *entry = request->add_updates()->mutable_entity()->mutable_table_entry();
+        entry->set_table_id(idx < 6 ? 1 : 2);
+        entry->set_priority(static_cast<int32_t>(idx));
+    }
+    config.push_back(std::move(request));
+    return config;
+}
+
+/// @returns a fresh base path in the temporary directory.
+std::filesystem::path makeBasePath(const std::string &name) {
+    auto dir = std::filesystem::temp_directory_path() / ("rtsmith_sharded_" + name);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir / "initial_config.txtpb";
+}
+
+/// Checks that the files contain all updates of @param config in order.
+void expectSameUpdates(const std::vector<std::unique_ptr<google::protobuf::Message>> &config,
+                       const std::vector<ShardedConfigWriter::ShardFile> &files) {
+    p4::v1::WriteRequest expected;
+    for (const auto &request : config) {
+        expected.MergeFrom(*request);
+    }
+    p4::v1::WriteRequest actual;
+    for (const auto &file : files) {
+        std::ifstream input(file.path, std::ios::binary);
+        std::stringstream content;
+        content << input.rdbuf();
+        auto text = content.str();
+        if (RtSmith::isGzip(text)) {
+            auto decompressed = RtSmith::decompressGzip(text);
+            ASSERT_TRUE(decompressed.has_value());
+            text = decompressed.value();
+        }
+        p4::v1::WriteRequest request;
+        ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(text, &request));
+        EXPECT_EQ(request.device_id(), 1U);
+        EXPECT_EQ(static_cast<uint64_t>(request.updates_size()), file.numUpdates);
+        EXPECT_EQ(std::filesystem::file_size(file.path), file.numBytes);
+        actual.MergeFrom(request);
+    }
+    EXPECT_EQ(actual.SerializeAsString(), expected.SerializeAsString());
+}
+
+// Shards never mix tables and new stages start when the entity kind changes.
+TEST(ShardedWriterTest, ShardsByTable) {
+    auto config = makeConfig();
+    ShardingPolicy policy;
+    policy.byTable = true;
+    policy.numThreads = 3;
+    auto basePath = makeBasePath("by_table");
+    auto files = ShardedConfigWriter(policy).write(config, basePath);
+    ASSERT_TRUE(files.has_value());
+    ASSERT_EQ(files->size(), 3U);
+    EXPECT_EQ(files->at(0).key, "action_profile_member:5");
+    EXPECT_EQ(files->at(0).stage, 0U);
+    EXPECT_EQ(files->at(1).key, "table_entry:1");
+    EXPECT_EQ(files->at(1).stage, 1U);
+    EXPECT_EQ(files->at(1).numUpdates, 6U);
+    EXPECT_EQ(files->at(2).key, "table_entry:2");
+    EXPECT_EQ(files->at(2).stage, 1U);
+    EXPECT_EQ(files->at(2).path.filename(), "initial_config.shard_2_0.txtpb");
+    expectSameUpdates(config, files.value());
+
+    std::ifstream manifest(ShardedConfigWriter::getManifestPath(basePath));
+    std::stringstream manifestText;
+    manifestText << manifest.rdbuf();
+    EXPECT_NE(manifestText.str().find(
+                  "{\"file\": \"initial_config.shard_1_0.txtpb\", \"shard\": 1, \"stage\": 1, "
+                  "\"key\": \"table_entry:1\", \"updates\": 6"),
+              std::string::npos);
+}
+
+// Shards are limited by the number of updates and rotated by size.
+TEST(ShardedWriterTest, LimitsUpdatesAndBytes) {
+    auto config = makeConfig();
+    ShardingPolicy policy;
+    policy.maxUpdates = 4;
+    policy.numThreads = 2;
+    auto files = ShardedConfigWriter(policy).write(config, makeBasePath("by_size"));
+    ASSERT_TRUE(files.has_value());
+    ASSERT_EQ(files->size(), 3U);
+    EXPECT_EQ(files->at(0).numUpdates, 3U);
+    EXPECT_EQ(files->at(1).numUpdates, 4U);
+    EXPECT_EQ(files->at(2).numUpdates, 4U);
+    EXPECT_TRUE(files->at(2).key.empty());
+    expectSameUpdates(config, files.value());
+
+    policy.maxUpdates = 0;
+    policy.maxBytes = 1;
+    files = ShardedConfigWriter(policy).write(config, makeBasePath("by_bytes"));
+    ASSERT_TRUE(files.has_value());
+    ASSERT_EQ(files->size(), 11U);
+    EXPECT_EQ(files->at(4).shard, 1U);
+    EXPECT_EQ(files->at(4).path.filename(), "initial_config.shard_1_1.txtpb");
+    expectSameUpdates(config, files.value());
+}
+
+// Compressed shards get the extension of the compression and are limited before compression.
+TEST(ShardedWriterTest, CompressesShards) {
+    auto config = makeConfig();
+    ShardingPolicy policy;
+    policy.byTable = true;
+    policy.maxBytes = 1;
+    auto files = ShardedConfigWriter(policy, RtSmith::Compression::Gzip)
+                     .write(config, makeBasePath("compressed"));
+    ASSERT_TRUE(files.has_value());
+    ASSERT_EQ(files->size(), 11U);
+    EXPECT_EQ(files->at(0).path.filename(), "initial_config.shard_0_0.txtpb.gz");
+    expectSameUpdates(config, files.value());
+}
+
+}  // namespace
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,69 @@
+#include "backends/p4tools/modules/rtsmith/core/table_selector.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "backends/p4tools/common/lib/util.h"
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::TableSelector;
+
+/// @returns candidates named "ingress.t<index>" with alias "t<index>" and @param weights.
+std::vector<TableSelector::Candidate> makeCandidates(const std::vector<double> &weights) {
+    std::vector<TableSelector::Candidate> candidates;
+    for (size_t index = 0; index < weights.size(); ++index) {
+        auto alias = "t" + std::to_string(index);
+        candidates.push_back({{"ingress." + alias, alias}, weights.at(index)});
+    }
+    return candidates;
+}
+
+// Skip patterns match exact names, aliases, and globs.
+TEST(TableSelectorTest, SkipsMatchingTables) {
+    TableSelector selector(makeCandidates({1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1}),
+                           {"t0", "ingress.t1", "ingress.t1?"}, 100);
+    EXPECT_TRUE(selector.isSkipped(0));
+    EXPECT_TRUE(selector.isSkipped(1));
+    EXPECT_FALSE(selector.isSkipped(2));
+    EXPECT_TRUE(selector.isSkipped(10));
+    EXPECT_TRUE(selector.isSkipped(11));
+    EXPECT_EQ(selector.select(), std::vector<int>({2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+// At most maxTables tables are selected and tables with a weight of 0 never are.
+TEST(TableSelectorTest, SelectsAtMostMaxTables) {
+    Utils::setRandomSeed(1);
+    TableSelector selector(makeCandidates({1, 0, 2, 3, 0, 4}), {}, 2);
+    for (int round = 0; round < 100; ++round) {
+        auto selected = selector.select();
+        ASSERT_EQ(selected.size(), 2U);
+        EXPECT_LT(selected.at(0), selected.at(1));
+        for (auto tableIndex : selected) {
+            EXPECT_NE(tableIndex, 1);
+            EXPECT_NE(tableIndex, 4);
+        }
+    }
+}
+
+// Tables are selected with probabilities that follow their weights.
+TEST(TableSelectorTest, PrefersHeavyTables) {
+    Utils::setRandomSeed(1);
+    TableSelector selector(makeCandidates({1, 99}), {}, 1);
+    int heavyCount = 0;
+    static constexpr int ROUNDS = 1000;
+    for (int round = 0; round < ROUNDS; ++round) {
+        auto selected = selector.select();
+        ASSERT_EQ(selected.size(), 1U);
+        heavyCount += selected.at(0) == 1 ? 1 : 0;
+    }
+    EXPECT_GT(heavyCount, ROUNDS * 95 / 100);
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
@@ -0,0 +1,78 @@
+#include "backends/p4tools/modules/rtsmith/core/table_state.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "p4/v1/p4runtime.pb.h"
+#pragma GCC diagnostic pop
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::computeCanonicalKey;
+using P4::P4Tools::RtSmith::TableState;
+
+// Entries are unique per key and can be looked up by key.
+TEST(TableStateTest, InsertsUniqueKeys) {
+    TableState<int> state;
+    EXPECT_TRUE(state.empty());
+    EXPECT_TRUE(state.insert("a", 1));
+    EXPECT_TRUE(state.insert("b", 2));
+    EXPECT_FALSE(state.insert("a", 3));
+    EXPECT_EQ(state.size(), 2U);
+    ASSERT_NE(state.find("a"), nullptr);
+    EXPECT_EQ(*state.find("a"), 1);
+    EXPECT_EQ(state.find("c"), nullptr);
+}
+
+// Erasing an entry keeps the remaining entries addressable by key and by position.
+TEST(TableStateTest, ErasesAndSamplesRemainingEntries) {
+    TableState<int> state;
+    state.insert("a", 1);
+    state.insert("b", 2);
+    state.insert("c", 3);
+    EXPECT_TRUE(state.erase("a"));
+    EXPECT_FALSE(state.erase("a"));
+    EXPECT_FALSE(state.contains("a"));
+    ASSERT_EQ(state.size(), 2U);
+    ASSERT_NE(state.find("c"), nullptr);
+    EXPECT_EQ(*state.find("c"), 3);
+
+    std::set<std::string> keys;
+    for (size_t position = 0; position < state.size(); position++) {
+        keys.insert(state.keyAt(position));
+        EXPECT_EQ(state.find(state.keyAt(position)), &state.entryAt(position));
+    }
+    EXPECT_EQ(keys, (std::set<std::string>{"b", "c"}));
+    EXPECT_LT(state.samplePosition(), state.size());
+}
+
+// The canonical key does not depend on the order of the key fields.
+TEST(TableStateTest, CanonicalKeyIgnoresFieldOrder) {
+    p4::v1::TableEntry entry;
+    auto *first = entry.add_match();
+    first->set_field_id(1);
+    first->mutable_exact()->set_value("\x01");
+    auto *second = entry.add_match();
+    second->set_field_id(2);
+    second->mutable_lpm()->set_value("\x02");
+    second->mutable_lpm()->set_prefix_len(8);
+
+    p4::v1::TableEntry reordered;
+    *reordered.add_match() = entry.match(1);
+    *reordered.add_match() = entry.match(0);
+    EXPECT_EQ(computeCanonicalKey(entry.match()), computeCanonicalKey(reordered.match()));
+
+    reordered.mutable_match(0)->mutable_lpm()->set_prefix_len(7);
+    EXPECT_NE(computeCanonicalKey(entry.match()), computeCanonicalKey(reordered.match()));
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
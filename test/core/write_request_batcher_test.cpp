@@ -0,0 +1,81 @@
+#include "backends/p4tools/modules/rtsmith/core/write_request_batcher.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Wpedantic"
+#include "p4/v1/p4runtime.pb.h"
+#pragma GCC diagnostic pop
+
+namespace P4::P4Tools::Test {
+
+namespace {
+
+using P4::P4Tools::RtSmith::WriteRequestBatcher;
+
+/// @returns an insert update whose single exact match field has a value of @param valueBytes
+/// bytes.
+p4::v1::Update makeUpdate(size_t valueBytes) {
+    p4::v1::Update update;
+    update.set_type(p4::v1::Update_Type::Update_Type_INSERT);
+    auto *entry = update.mutable_entity()->mutable_table_entry();
+    entry->set_table_id(1);
+    auto *match = entry->add_match();
+    match->set_field_id(1);
+    match->mutable_exact()->set_value(std::string(valueBytes, 'x'));
+    return update;
+}
+
+// Requests are completed once they reach the maximum number of updates.
+TEST(WriteRequestBatcherTest, SplitsByUpdateCount) {
+    WriteRequestBatcher<p4::v1::WriteRequest> batcher(2, 0);
+    for (int idx = 0; idx < 5; idx++) {
+        batcher.add(makeUpdate(4));
+    }
+    EXPECT_EQ(batcher.pendingUpdates(), 1U);
+    batcher.flush();
+    auto requests = batcher.takeRequests();
+    ASSERT_EQ(requests.size(), 3U);
+    EXPECT_EQ(requests[0]->updates_size(), 2);
+    EXPECT_EQ(requests[1]->updates_size(), 2);
+    EXPECT_EQ(requests[2]->updates_size(), 1);
+    EXPECT_TRUE(batcher.takeRequests().empty());
+}
+
+// The tracked size matches the serialized size of the request, which never exceeds the limit.
+TEST(WriteRequestBatcherTest, SplitsByEncodedSize) {
+    auto updateBytes = makeUpdate(100).ByteSizeLong();
+    p4::v1::WriteRequest singleUpdateRequest;
+    *singleUpdateRequest.add_updates() = makeUpdate(100);
+    auto maxBytes = 3 * singleUpdateRequest.ByteSizeLong();
+    ASSERT_GT(singleUpdateRequest.ByteSizeLong(), updateBytes);
+
+    WriteRequestBatcher<p4::v1::WriteRequest> batcher(0, maxBytes);
+    for (int idx = 0; idx < 7; idx++) {
+        batcher.add(makeUpdate(100));
+    }
+    batcher.flush();
+    auto requests = batcher.takeRequests();
+    ASSERT_EQ(requests.size(), 3U);
+    for (const auto &request : requests) {
+        EXPECT_LE(request->ByteSizeLong(), maxBytes);
+    }
+    EXPECT_EQ(requests[0]->ByteSizeLong(), maxBytes);
+    EXPECT_EQ(requests[2]->updates_size(), 1);
+
+    // An update that exceeds the limit on its own gets a request of its own.
+    batcher.add(makeUpdate(10));
+    batcher.add(makeUpdate(1000));
+    batcher.add(makeUpdate(10));
+    batcher.flush();
+    requests = batcher.takeRequests();
+    ASSERT_EQ(requests.size(), 3U);
+    EXPECT_EQ(requests[1]->updates_size(), 1);
+}
+
+}  // anonymous namespace
+
+}  // namespace P4::P4Tools::Test
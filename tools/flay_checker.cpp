@@ -1,11 +1,29 @@
+#include <google/protobuf/message.h>
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
 #include <random>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "backends/p4tools/common/compiler/context.h"
 #include "backends/p4tools/common/lib/logging.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "backends/p4tools/modules/flay/flay.h"
 #include "backends/p4tools/modules/flay/register.h"
+#include "backends/p4tools/modules/rtsmith/core/compressed_file.h"
 #include "backends/p4tools/modules/rtsmith/core/util.h"
 #include "backends/p4tools/modules/rtsmith/options.h"
 #include "backends/p4tools/modules/rtsmith/register.h"
@@ -13,7 +31,9 @@
 #include "frontends/common/parser_options.h"
 #include "lib/compile_context.h"
 #include "lib/error.h"
+#include "lib/nullstream.h"
 #include "lib/options.h"
+#include "lib/timer.h"
 
 namespace P4::P4Tools::RtSmith {
 
@@ -24,6 +44,8 @@ class FlayCheckerOptions : public RtSmithOptions {
     bool _writePerformanceReport = false;
     /// Skip parser processing in Flay.
     bool _skipParsers = false;
+    /// Re-analyze the program for every prefix of the updates and write the results to this file.
+    std::optional<std::filesystem::path> _prefixReanalysisReport;
 
  public:
     FlayCheckerOptions() {
@@ -61,6 +83,17 @@ class FlayCheckerOptions : public RtSmithOptions {
                 return true;
             },
             "Skip parser processing in Flay.");
+        registerOption(
+            "--prefix-reanalysis-report", "file",
+            [this](const char *arg) {
+                _prefixReanalysisReport = arg;
+                return true;
+            },
+            "Run a full Flay analysis of the initial configuration followed by every prefix of the "
+            "configuration updates, and write the duration and the resident memory of every run "
+            "to the file. Every run compiles and analyzes the program from scratch, it does not "
+            "measure an incremental analysis. The file is written as JSON if its extension is "
+            ".json, as CSV otherwise.");
     }
 
     ~FlayCheckerOptions() override = default;
@@ -82,6 +115,12 @@ class FlayCheckerOptions : public RtSmithOptions {
             error("No input file specified.");
             return EXIT_FAILURE;
         }
+        // Flay reads the initial configuration from a single file, which is not written if the
+        // configuration is sharded.
+        if (_shardingPolicy.isEnabled()) {
+            error("flay_checker does not support sharded initial configurations.");
+            return EXIT_FAILURE;
+        }
         if (_outputDir.empty()) {
             _outputDir = std::tmpnam(nullptr);
             printInfo("Using temporary directory: %s", _outputDir.c_str());
@@ -101,13 +140,276 @@ class FlayCheckerOptions : public RtSmithOptions {
     [[nodiscard]] bool writePerformanceReport() const { return _writePerformanceReport; }
 
     [[nodiscard]] bool skipParsers() const { return _skipParsers; }
+
+    [[nodiscard]] const std::optional<std::filesystem::path> &prefixReanalysisReport() const {
+        return _prefixReanalysisReport;
+    }
+};
+
+/// The full re-analysis of the initial configuration and a prefix of the configuration updates.
+struct PrefixReanalysisSample {
+    /// The number of configuration updates in the prefix.
+    size_t numUpdates = 0;
+    /// The delay before the last update of the prefix in the update series, in microseconds.
+    uint64_t delayMicroseconds = 0;
+    /// The number of entities the last update of the prefix changes.
+    int size = 0;
+    /// The duration of the run, in microseconds.
+    int64_t runMicroseconds = 0;
+    /// The duration of the run minus the duration of the run of the prefix without the last
+    /// update, in microseconds.
+    int64_t marginalMicroseconds = 0;
+    /// The resident set size of the process after the run, in kilobytes.
+    int64_t residentMemoryKb = 0;
+    /// The resident set size after the run minus the one after the previous run, in kilobytes.
+    int64_t residentMemoryDeltaKb = 0;
+    /// Whether the marginal duration per entity is an outlier among all prefixes.
+    bool outlier = false;
 };
 
+/// Decompress the configuration files that RtSmith wrote to @param outputDir with
+/// @param compression. Flay only parses uncompressed files, so every file is decompressed next to
+/// the compressed one, e.g., "update_1.txtpb.gz" to "update_1.txtpb".
+/// @returns false if a file can not be decompressed.
+bool decompressConfiguration(const std::filesystem::path &outputDir, Compression compression) {
+    Util::ScopedTimer timer("Decompress configuration");
+    const auto suffix = getCompressedPath(".txtpb", compression).string();
+    for (const auto &entry : std::filesystem::directory_iterator(outputDir)) {
+        auto name = entry.path().filename().string();
+        if (name.size() <= suffix.size() ||
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+            continue;
+        }
+        std::ifstream input(entry.path(), std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(input)),
+                            std::istreambuf_iterator<char>());
+        auto decompressed = decompressGzip(content);
+        if (input.bad() || !decompressed.has_value()) {
+            error(ErrorType::ERR_IO, "Failed to decompress %1%", entry.path());
+            return false;
+        }
+        auto outputPath = entry.path();
+        outputPath.replace_extension();
+        CompressedOutputFile output;
+        if (!output.open(outputPath, Compression::None) || !output.write(decompressed.value()) ||
+            !output.close()) {
+            error(ErrorType::ERR_IO, "Failed to write %1%", outputPath);
+            return false;
+        }
+    }
+    return true;
+}
+
+/// @returns the current resident set size of the process in kilobytes, 0 if it is not available.
+/// Unlike the peak resident set size, it also shrinks when memory is released.
+int64_t getResidentMemoryKb() {
+#ifdef __APPLE__
+    mach_task_basic_info info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<int64_t>(info.resident_size / 1024);
+#else
+    // The second field of statm is the number of resident pages.
+    std::ifstream statm("/proc/self/statm");
+    int64_t size = 0;
+    int64_t residentPages = 0;
+    if (!(statm >> size >> residentPages)) {
+        return 0;
+    }
+    return residentPages * sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+/// @returns the number of entities @param request changes, i.e., the size of its "updates" field.
+int getUpdateSize(const google::protobuf::Message &request) {
+    const auto *field = request.GetDescriptor()->FindFieldByName("updates");
+    if (field == nullptr || !field->is_repeated()) {
+        return 1;
+    }
+    return request.GetReflection()->FieldSize(request, field);
+}
+
+/// Flag the samples whose marginal duration per entity is an outlier. A sample is an outlier if
+/// its modified z-score, which is based on the median and the median absolute deviation, exceeds
+/// 3.5.
+void flagOutliers(std::vector<PrefixReanalysisSample> &samples) {
+    if (samples.size() < 3) {
+        return;
+    }
+    auto median = [](std::vector<double> values) {
+        auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    };
+    std::vector<double> durations;
+    durations.reserve(samples.size());
+    for (const auto &sample : samples) {
+        durations.push_back(static_cast<double>(sample.marginalMicroseconds) /
+                            std::max(sample.size, 1));
+    }
+    auto durationMedian = median(durations);
+    std::vector<double> deviations;
+    deviations.reserve(durations.size());
+    for (auto duration : durations) {
+        deviations.push_back(std::abs(duration - durationMedian));
+    }
+    auto deviationMedian = median(deviations);
+    if (deviationMedian == 0) {
+        return;
+    }
+    static constexpr double MAD_SCALE = 0.6745;
+    static constexpr double OUTLIER_THRESHOLD = 3.5;
+    for (size_t idx = 0; idx < samples.size(); ++idx) {
+        auto score = MAD_SCALE * (durations.at(idx) - durationMedian) / deviationMedian;
+        samples.at(idx).outlier = score > OUTLIER_THRESHOLD;
+    }
+}
+
+/// Write @param samples to @param path, as JSON if the extension is .json and as CSV otherwise.
+/// @returns false if the file can not be written.
+bool writePrefixReanalysisReport(const std::filesystem::path &path,
+                                 const std::vector<PrefixReanalysisSample> &samples) {
+    auto *outputFile = openFile(path, true);
+    if (outputFile == nullptr) {
+        error(ErrorType::ERR_IO, "Failed to open %1%", path);
+        return false;
+    }
+    if (path.extension() == ".json") {
+        *outputFile << "[\n";
+        for (size_t idx = 0; idx < samples.size(); ++idx) {
+            const auto &sample = samples.at(idx);
+            *outputFile << "  {\"updates\": " << sample.numUpdates
+                        << ", \"delay_us\": " << sample.delayMicroseconds
+                        << ", \"size\": " << sample.size
+                        << ", \"run_us\": " << sample.runMicroseconds
+                        << ", \"marginal_us\": " << sample.marginalMicroseconds
+                        << ", \"resident_memory_kb\": " << sample.residentMemoryKb
+                        << ", \"resident_memory_delta_kb\": " << sample.residentMemoryDeltaKb
+                        << ", \"outlier\": " << (sample.outlier ? "true" : "false") << "}"
+                        << (idx + 1 < samples.size() ? ",\n" : "\n");
+        }
+        *outputFile << "]\n";
+    } else {
+        *outputFile << "updates,delay_us,size,run_us,marginal_us,resident_memory_kb,"
+                       "resident_memory_delta_kb,outlier\n";
+        for (const auto &sample : samples) {
+            *outputFile << sample.numUpdates << "," << sample.delayMicroseconds << ","
+                        << sample.size << "," << sample.runMicroseconds << ","
+                        << sample.marginalMicroseconds << "," << sample.residentMemoryKb << ","
+                        << sample.residentMemoryDeltaKb << "," << (sample.outlier ? 1 : 0)
+                        << "\n";
+        }
+    }
+    outputFile->flush();
+    if (!outputFile->good()) {
+        error(ErrorType::ERR_IO, "Failed to write the prefix re-analysis report to %1%", path);
+        return false;
+    }
+    return true;
+}
+
+/// Print the statistics of the Flay analyses.
+template <typename StatisticsMap>
+void printFlayStatistics(const StatisticsMap &flayServiceStatistics) {
+    printInfo("Statistics:");
+    for (const auto &[analysisName, statistic] : flayServiceStatistics) {
+        printInfo("#####\n%1%:\n%2%#####", analysisName, statistic->toFormattedString());
+    }
+}
+
+/// Run a full Flay analysis for every prefix of the configuration updates of @param updateSeries,
+/// on top of the initial configuration set in @param flayOptions. Every prefix extends the
+/// previous one, so every update is analyzed in the state the earlier updates leave behind. Flay
+/// has no incremental entry point, so every run compiles and analyzes the program from scratch.
+/// The update files of a prefix are copied from @param outputDir into a subdirectory, which the
+/// update pattern of Flay refers to.
+int runPrefixReanalysis(const FlayCheckerOptions &options, Flay::FlayOptions &flayOptions,
+                        const std::filesystem::path &outputDir, const UpdateSeries &updateSeries) {
+    auto prefixDir = outputDir / "prefix";
+    std::error_code errorCode;
+    std::filesystem::remove_all(prefixDir, errorCode);
+    if (!std::filesystem::create_directory(prefixDir, errorCode)) {
+        error(ErrorType::ERR_IO, "Failed to create %1%", prefixDir);
+        return EXIT_FAILURE;
+    }
+    flayOptions.setConfigurationUpdatePattern(prefixDir / "update_*.txtpb");
+    auto measureRun = [&flayOptions]() {
+        auto start = std::chrono::steady_clock::now();
+        auto result = Flay::Flay::optimizeProgram(flayOptions);
+        auto end = std::chrono::steady_clock::now();
+        return std::make_pair(
+            std::move(result),
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    };
+    // The first run covers the empty prefix, i.e., only the initial configuration.
+    auto [initialRun, previousRunMicroseconds] = measureRun();
+    if (!initialRun.has_value()) {
+        return EXIT_FAILURE;
+    }
+    auto previousResidentMemoryKb = getResidentMemoryKb();
+
+    // Zero-padded indices keep the copies in order, whether Flay sorts the matches of the pattern
+    // by name or by number.
+    const auto indexWidth = std::to_string(updateSeries.size()).size();
+    std::vector<PrefixReanalysisSample> samples;
+    // Update files are numbered by their position in the update series, starting at 1.
+    size_t position = 0;
+    for (const auto &[microseconds, request] : updateSeries) {
+        position++;
+        if (request->GetDescriptor()->name() == "ReadRequest") {
+            continue;
+        }
+        auto updatePath = outputDir / ("update_" + std::to_string(position) + ".txtpb");
+        auto index = std::to_string(samples.size() + 1);
+        index.insert(0, indexWidth - index.size(), '0');
+        auto prefixPath = prefixDir / ("update_" + index + ".txtpb");
+        if (!std::filesystem::copy_file(updatePath, prefixPath, errorCode)) {
+            error(ErrorType::ERR_IO, "Failed to copy configuration update file %1%", updatePath);
+            return EXIT_FAILURE;
+        }
+        PrefixReanalysisSample sample;
+        sample.numUpdates = samples.size() + 1;
+        sample.delayMicroseconds = microseconds;
+        sample.size = getUpdateSize(*request);
+        auto [result, runMicroseconds] = measureRun();
+        if (!result.has_value()) {
+            error("Flay failed to analyze the first %1% configuration updates.", sample.numUpdates);
+            return EXIT_FAILURE;
+        }
+        sample.runMicroseconds = runMicroseconds;
+        sample.marginalMicroseconds = runMicroseconds - previousRunMicroseconds;
+        sample.residentMemoryKb = getResidentMemoryKb();
+        sample.residentMemoryDeltaKb = sample.residentMemoryKb - previousResidentMemoryKb;
+        previousRunMicroseconds = runMicroseconds;
+        previousResidentMemoryKb = sample.residentMemoryKb;
+        samples.push_back(sample);
+    }
+    flagOutliers(samples);
+    for (const auto &sample : samples) {
+        if (sample.outlier) {
+            warning(
+                "Re-analysis with configuration update %1% (%2% entities) took %3% microseconds "
+                "longer than without it.",
+                sample.numUpdates, sample.size, sample.marginalMicroseconds);
+        }
+    }
+    if (!writePrefixReanalysisReport(options.prefixReanalysisReport().value(), samples)) {
+        return EXIT_FAILURE;
+    }
+    printInfo("Flay prefix re-analysis complete.");
+    printFlayStatistics(initialRun.value());
+    return EXIT_SUCCESS;
+}
+
 }  // namespace
 
 int run(const FlayCheckerOptions &options, const RtSmithOptions &rtSmithOptions) {
     printInfo("Generating RtSmith configuration for program...");
-    if (!RtSmith::generateConfig(rtSmithOptions)) {
+    auto rtSmithResult = RtSmith::generateConfig(rtSmithOptions);
+    if (!rtSmithResult.has_value()) {
         return EXIT_FAILURE;
     }
 
@@ -128,15 +430,20 @@ int run(const FlayCheckerOptions &options, const RtSmithOptions &rtSmithOptions)
         }
         flayOptions.setControlPlaneApi(std::string(rtSmithOptions.controlPlaneApi()));
         flayOptions.preprocessor_options = rtSmithOptions.preprocessor_options;
+        if (rtSmithOptions.compression() != Compression::None &&
+            !decompressConfiguration(rtSmithOptions.outputDir(), rtSmithOptions.compression())) {
+            return EXIT_FAILURE;
+        }
         flayOptions.setControlPlaneConfig(rtSmithOptions.outputDir() / "initial_config.txtpb");
+        if (options.prefixReanalysisReport().has_value()) {
+            return runPrefixReanalysis(options, flayOptions, rtSmithOptions.outputDir(),
+                                       rtSmithResult->updateSeries);
+        }
         flayOptions.setConfigurationUpdatePattern(rtSmithOptions.outputDir() / "*update_*.txtpb");
         ASSIGN_OR_RETURN(auto flayServiceStatistics, Flay::Flay::optimizeProgram(flayOptions),
                          EXIT_FAILURE);
         printInfo("Flay optimization complete.");
-        printInfo("Statistics:");
-        for (const auto &[analysisName, statistic] : flayServiceStatistics) {
-            printInfo("#####\n%1%:\n%2%#####", analysisName, statistic->toFormattedString());
-        }
+        printFlayStatistics(flayServiceStatistics);
     }
 
     return EXIT_SUCCESS;